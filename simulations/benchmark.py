@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see http://www.gnu.org/licenses/.
+#
+
+"""Runs MegaMerger and Dijkstra over the bundled topology families at
+growing sizes, one Cmdenv process at a time, and writes a JSON file with
+the wall time, events per second, peak RSS, messages per node and
+simulated convergence time of every case. Given a baseline file written
+by an earlier run, it flags the cases that got worse and exits with 1.
+
+  ./benchmark.py --output before.json
+  ./benchmark.py --output after.json --baseline before.json
+
+Chain, Ring and Grid take their size as a parameter. Tree, Mesh and Mesh2
+are hand-drawn networks of fixed size, so they are scaled by the network
+builder: Tree by a binary tree, Mesh and Mesh2 by connected random graphs
+with their mean degree and weights. Zero is a random geometric graph
+whose integer weights include 0, so the oracle sees links that add
+nothing to a path. Dijkstra keeps a routing table per node, so it stops
+at --dijkstra-max nodes.
+"""
+
+import argparse
+import collections
+import json
+import math
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+from sweep import HERE, default_binary, read_scalars
+
+
+def fixed(network, **params):
+    return ['--network=dsbase.simulations.' + network] + \
+           ['--*.%s=%s' % (name, value) for name, value in params.items()]
+
+
+def generated(model, n, degree, weights, low=1, high=10):
+    return fixed('Generated', model='"%s"' % model, n=n, degree=degree,
+                 weights='"%s"' % weights, minWeight=low, maxWeight=high)
+
+
+def grid(n):
+    side = max(1, int(round(math.sqrt(n))))
+    return fixed('Grid', rows=side, columns=side)
+
+
+FAMILIES = collections.OrderedDict([
+    ('Chain', lambda n: fixed('Chain', size=n)),
+    ('Ring', lambda n: fixed('Ring', size=n)),
+    ('Grid', grid),
+    ('Tree', lambda n: generated('tree', n, 2, 'unit')),
+    ('Mesh', lambda n: generated('er', n, 3.3, 'unit')),
+    ('Mesh2', lambda n: generated('er', n, 3.5, 'integer')),
+    ('Zero', lambda n: generated('rgg', n, 6, 'integer', 0, 2)),
+])
+
+PROTOCOLS = ('MegaMerger', 'Dijkstra')
+
+# (metric, +1 if higher is better or -1 if lower is better, noisy). Noisy
+# metrics are compared up to the tolerance, the other ones are exact
+METRICS = (
+    ('wallTime', -1, True),
+    ('eventsPerSecond', +1, True),
+    ('peakRssKiB', -1, True),
+    ('messagesPerNode', -1, False),
+    ('mstTime', -1, False),
+    ('routingTime', -1, False),
+)
+
+END = re.compile(r'at t=([-+0-9.eE]+)s?, event #(\d+)')
+
+
+def run_case(args, protocol, family, n, directory):
+    """Runs a case and returns its metrics, or None if the run failed."""
+    command = [args.binary, '-n', '.:../src', '-u', 'Cmdenv', '-c', 'Benchmark',
+               '--result-dir=' + directory, '--*.kind="%s"' % protocol] + FAMILIES[family](n) + args.options
+    log = os.path.join(directory, 'out.txt')
+    with open(log, 'w') as out:
+        start = time.perf_counter()
+        process = subprocess.Popen(command, cwd=HERE, stdout=out, stderr=subprocess.STDOUT)
+        # wait4() reports the peak RSS of this process only
+        _, status, usage = os.wait4(process.pid, 0)
+        wall = time.perf_counter() - start
+    process.returncode = os.WEXITSTATUS(status) if os.WIFEXITED(status) else -1
+    if status != 0:
+        return None
+    with open(log) as f:
+        ends = END.findall(f.read())
+    events = int(ends[-1][1]) if ends else 0
+    network = {}
+    for path in os.listdir(directory):
+        if path.endswith('.sca'):
+            for module, name, value in read_scalars(os.path.join(directory, path))[2]:
+                # The network module records the network-wide scalars
+                if '.' not in module:
+                    network[name] = value
+            os.remove(os.path.join(directory, path))
+    nodes = network.get('nodes', n)
+    return collections.OrderedDict([
+        ('wallTime', wall),
+        ('events', events),
+        ('eventsPerSecond', events / wall if wall > 0 else 0.0),
+        ('peakRssKiB', usage.ru_maxrss),
+        ('nodes', nodes),
+        ('messagesPerNode', network.get('sent', 0.0) / nodes if nodes else 0.0),
+        ('mstTime', network.get('mstTime')),
+        ('routingTime', network.get('routingTime')),
+    ])
+
+
+def best(results):
+    """Keeps the fastest repetition, the other metrics do not change."""
+    return min(results, key=lambda metrics: metrics['wallTime'])
+
+
+def key(case):
+    return case['protocol'], case['family'], case['n']
+
+
+def compare(cases, baseline, tolerance):
+    """Returns the lines describing the metrics worse than in the baseline."""
+    previous = {key(case): case for case in baseline['cases']}
+    regressions = []
+    for case in cases:
+        old = previous.get(key(case))
+        if not old or case.get('failed') or old.get('failed'):
+            continue
+        for metric, sign, noisy in METRICS:
+            new_value, old_value = case.get(metric), old.get(metric)
+            if new_value is None or old_value is None:
+                continue
+            allowed = tolerance * abs(old_value) if noisy else 1e-9 * max(1.0, abs(old_value))
+            if sign * (new_value - old_value) < -allowed:
+                regressions.append('%s %s n=%d: %s %.6g -> %.6g'
+                                   % (case['protocol'], case['family'], case['n'], metric, old_value, new_value))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--binary', default=default_binary(), help='the simulation binary, build sim_bench by make bench')
+    parser.add_argument('--output', default=os.path.join(HERE, 'results', 'benchmark.json'), help='the result file')
+    parser.add_argument('--baseline', help='a result file of an earlier run to compare with')
+    parser.add_argument('--tolerance', type=float, default=0.1,
+                        help='the relative slack of wall time, events per second and RSS (default: 0.1)')
+    parser.add_argument('--protocols', default=','.join(PROTOCOLS), help='comma-separated protocols')
+    parser.add_argument('--families', default=','.join(FAMILIES), help='comma-separated topology families')
+    parser.add_argument('--sizes', default='10,100,1000,10000,100000', help='comma-separated network sizes')
+    parser.add_argument('--dijkstra-max', type=int, default=1000, help='the largest network Dijkstra runs on')
+    parser.add_argument('--repeat', type=int, default=1, help='runs per case, the fastest one is kept')
+    parser.add_argument('options', nargs='*', help='extra options for the simulation, after --')
+    args = parser.parse_args()
+    args.binary = os.path.abspath(args.binary)
+    sizes = [int(size) for size in args.sizes.split(',')]
+    families = args.families.split(',')
+    for family in families:
+        if family not in FAMILIES:
+            parser.error('unknown family %s' % family)
+    cases = []
+    with tempfile.TemporaryDirectory(prefix='benchmark-') as directory:
+        for protocol in args.protocols.split(','):
+            for family in families:
+                for n in sizes:
+                    if protocol == 'Dijkstra' and n > args.dijkstra_max:
+                        continue
+                    results = [run_case(args, protocol, family, n, directory) for _ in range(args.repeat)]
+                    case = collections.OrderedDict([('protocol', protocol), ('family', family), ('n', n)])
+                    if None in results:
+                        case['failed'] = True
+                        sys.stderr.write('%-10s %-6s %7d failed\n' % (protocol, family, n))
+                    else:
+                        case.update(best(results))
+                        sys.stderr.write('%-10s %-6s %7d %9.3fs %12.0f ev/s %9d KiB %8.2f msg/node\n'
+                                         % (protocol, family, n, case['wallTime'], case['eventsPerSecond'],
+                                            case['peakRssKiB'], case['messagesPerNode']))
+                    cases.append(case)
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    with open(args.output, 'w') as f:
+        json.dump({'binary': args.binary, 'date': time.strftime('%Y-%m-%d %H:%M:%S'), 'cases': cases}, f, indent=2)
+    sys.stderr.write('%d cases written to %s\n' % (len(cases), args.output))
+    failed = sum(1 for case in cases if case.get('failed'))
+    if args.baseline:
+        with open(args.baseline) as f:
+            regressions = compare(cases, json.load(f), args.tolerance)
+        for line in regressions:
+            sys.stderr.write('REGRESSION ' + line + '\n')
+        sys.stderr.write('%d regressions against %s\n' % (len(regressions), args.baseline))
+        failed += len(regressions)
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
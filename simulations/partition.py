@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see http://www.gnu.org/licenses/.
+#
+
+"""Assigns node[] to the partitions of a parallel simulation.
+
+With an edge-list file (see src/EdgeListLoader.h), nodes are split into k
+balanced parts grown by breadth-first search and refined by moving boundary
+nodes to the part holding most of their neighbors, which reduces the number
+of cut links. Nodes are then renumbered so every part is a contiguous range
+of IDs, the renumbered edge list is written, and so are the partition-id
+lines of omnetpp.ini, one index range per part.
+
+Without a file (--nodes), the ranges of an n-node network are written. That
+suits the grid, torus and rgg models of NetworkBuilder, whose IDs already
+follow the geometry of the network.
+
+  ./partition.py -k 4 --edges topology.txt --output topology-4.txt
+  ./partition.py -k 4 --nodes 1000000
+"""
+
+import argparse
+import collections
+import struct
+import sys
+
+
+def read_edges(path):
+    """Returns the links (src, dst, weight) of a text or binary edge list."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    edges = []
+    if data[:4] == b'DSEL':
+        if (len(data) - 4) % 16:
+            sys.exit('%s is truncated, %d bytes follow the last record' % (path, (len(data) - 4) % 16))
+        for u, v, w in struct.iter_unpack('<iid', data[4:]):
+            if u != v:
+                edges.append((u, v, w))
+        return edges
+    for line in data.decode().splitlines():
+        fields = line.replace(',', ' ').split()
+        if not fields or fields[0][0] in '#%':
+            continue
+        u, v = int(fields[0]), int(fields[1])
+        w = float(fields[2]) if len(fields) > 2 else 1.0
+        if u != v:
+            edges.append((u, v, w))
+    return edges
+
+
+def grow(n, adjacency, k):
+    """Splits the nodes into k parts of n/k nodes in breadth-first order."""
+    part = [-1] * n
+    seen = [False] * n
+    size = (n + k - 1) // k
+    current, filled = 0, 0
+    for root in range(n):
+        if seen[root]:
+            continue
+        queue = collections.deque([root])
+        seen[root] = True
+        while queue:
+            u = queue.popleft()
+            part[u] = current
+            filled += 1
+            if filled == size:
+                current, filled = min(current + 1, k - 1), 0
+            for v in adjacency[u]:
+                if not seen[v]:
+                    seen[v] = True
+                    queue.append(v)
+    return part
+
+
+def refine(n, adjacency, part, k, passes, slack):
+    """Moves nodes to the part most of their neighbors belong to, as long as
+    no part exceeds its share by more than a factor of 1 + slack."""
+    limit = int((1 + slack) * n / k) + 1
+    count = collections.Counter(part)
+    for _ in range(passes):
+        moved = 0
+        for u in range(n):
+            votes = collections.Counter(part[v] for v in adjacency[u])
+            if not votes:
+                continue
+            best, gain = part[u], votes[part[u]]
+            for p, c in votes.items():
+                if c > gain and count[p] < limit:
+                    best, gain = p, c
+            if best != part[u]:
+                count[part[u]] -= 1
+                count[best] += 1
+                part[u] = best
+                moved += 1
+        if moved == 0:
+            break
+    return part
+
+
+def ini_lines(sizes):
+    lines, first = [], 0
+    for p, size in enumerate(sizes):
+        if size > 0:
+            lines.append('*.node[%d..%d].partition-id = %d' % (first, first + size - 1, p))
+        first += size
+    return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('-k', '--partitions', type=int, required=True)
+    parser.add_argument('--edges', help='the edge-list file of the network')
+    parser.add_argument('--nodes', type=int, help='the number of nodes of a generated network')
+    parser.add_argument('--output', help='the renumbered edge list (default: <edges>.part)')
+    parser.add_argument('--ini', help='the omnetpp.ini fragment (default: standard output)')
+    parser.add_argument('--passes', type=int, default=4, help='refinement passes')
+    parser.add_argument('--slack', type=float, default=0.03, help='allowed imbalance')
+    args = parser.parse_args()
+    k = args.partitions
+    if args.edges:
+        edges = read_edges(args.edges)
+        n = 1 + max(max(u, v) for u, v, _ in edges) if edges else 0
+        adjacency = [[] for _ in range(n)]
+        for u, v, _ in edges:
+            adjacency[u].append(v)
+            adjacency[v].append(u)
+        isolated = [u for u in range(n) if not adjacency[u]]
+        if isolated:
+            sys.exit('%d node IDs of %s are in no link, the first is %d' % (len(isolated), args.edges, isolated[0]))
+        part = refine(n, adjacency, grow(n, adjacency, k), k, args.passes, args.slack)
+        # Part p takes the IDs following the ones of parts 0..p-1
+        sizes = [0] * k
+        for p in part:
+            sizes[p] += 1
+        offset = [sum(sizes[:p]) for p in range(k)]
+        label = [0] * n
+        for u in range(n):
+            label[u] = offset[part[u]]
+            offset[part[u]] += 1
+        cut = sum(1 for u, v, _ in edges if part[u] != part[v])
+        output = args.output or args.edges + '.part'
+        with open(output, 'w') as f:
+            f.write('# %s split into %d partitions, %d of %d links cut\n' % (args.edges, k, cut, len(edges)))
+            for u, v, w in edges:
+                f.write('%d %d %r\n' % (label[u], label[v], w))
+        sys.stderr.write('%d nodes, %d links, %d cut (%.1f%%), written to %s\n'
+                         % (n, len(edges), cut, 100.0 * cut / max(len(edges), 1), output))
+    elif args.nodes:
+        sizes = [args.nodes * (p + 1) // k - args.nodes * p // k for p in range(k)]
+    else:
+        parser.error('either --edges or --nodes is required')
+    text = '\n'.join(ini_lines(sizes)) + '\n'
+    if args.ini:
+        with open(args.ini, 'w') as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see http://www.gnu.org/licenses/.
+#
+
+"""Runs every run of one or more configurations as concurrent Cmdenv
+processes, one per core by default, and aggregates the scalars they record
+into one CSV file with a row per (run, scalar): the iteration variables of
+the run and the count, sum, mean, min and max of the scalar over modules.
+
+  ./sweep.py -c Sweep
+  ./sweep.py -c Sweep -c GeneratedRandom -j 8 --summary sweep.csv
+"""
+
+import argparse
+import collections
+import concurrent.futures
+import csv
+import glob
+import os
+import subprocess
+import sys
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+
+def default_binary():
+    for name in ('sim_bench', 'sim', 'sim_dbg'):
+        path = os.path.join(HERE, '..', 'src', name)
+        if os.path.exists(path):
+            return path
+    return os.path.join(HERE, '..', 'src', 'sim_dbg')
+
+
+def command(args, config, extra=()):
+    return [args.binary, '-n', '.:../src', '-u', 'Cmdenv', '-c', config] + list(extra) + args.options
+
+
+def count_runs(args, config):
+    out = subprocess.run(command(args, config, ['-q', 'numruns']), cwd=HERE,
+                         stdout=subprocess.PIPE, universal_newlines=True, check=True).stdout
+    for line in out.splitlines():
+        if line.startswith('Number of runs:'):
+            return int(line.split(':')[1])
+    return int(out.split()[-1])
+
+
+def run(args, config, number):
+    log = os.path.join(args.results, '%s-%d.out' % (config, number))
+    start = time.time()
+    with open(log, 'w') as f:
+        status = subprocess.call(command(args, config, ['-r', str(number), '--result-dir=' + args.results]),
+                                 cwd=HERE, stdout=f, stderr=subprocess.STDOUT)
+    return config, number, status, time.time() - start
+
+
+def unquote(text):
+    """Returns the value of a possibly quoted field of a result file."""
+    if len(text) >= 2 and text[0] == text[-1] == '"':
+        text = text[1:-1].replace('\\"', '"')
+    return text.strip('"')
+
+
+def read_scalars(path):
+    """Returns the attributes, the iteration variables and the scalars
+    (module, name, value) of a .sca file."""
+    attributes, itervars, scalars = {}, collections.OrderedDict(), []
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if not fields:
+                continue
+            if fields[0] == 'attr' and len(fields) >= 3:
+                attributes[fields[1]] = unquote(' '.join(fields[2:]))
+            elif fields[0] == 'itervar' and len(fields) >= 3:
+                itervars[fields[1]] = unquote(' '.join(fields[2:]))
+            elif fields[0] == 'scalar' and len(fields) >= 4:
+                try:
+                    scalars.append((fields[1], unquote(fields[2]), float(fields[3])))
+                except ValueError:
+                    pass
+    # Older result files only list the iteration variables as an attribute
+    if not itervars and attributes.get('iterationvars'):
+        for item in attributes['iterationvars'].split(','):
+            name, _, value = item.strip().lstrip('$').partition('=')
+            itervars[name] = value.strip('"')
+    return attributes, itervars, scalars
+
+
+def summarize(args, configs):
+    rows, variables = [], []
+    for config in configs:
+        for path in sorted(glob.glob(os.path.join(args.results, config + '-*.sca'))):
+            attributes, itervars, scalars = read_scalars(path)
+            for name in itervars:
+                if name not in variables:
+                    variables.append(name)
+            values = collections.OrderedDict()
+            for _, name, value in scalars:
+                values.setdefault(name, []).append(value)
+            for name, v in values.items():
+                rows.append((config, attributes.get('runnumber', ''), itervars, name,
+                             len(v), sum(v), sum(v) / len(v), min(v), max(v)))
+    with open(args.summary, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(['config', 'run'] + variables + ['scalar', 'count', 'sum', 'mean', 'min', 'max'])
+        for config, number, itervars, name, count, total, mean, low, high in rows:
+            writer.writerow([config, number] + [itervars.get(v, '') for v in variables]
+                            + [name, count, total, mean, low, high])
+    return len(rows)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('-c', '--config', action='append', required=True, help='a configuration of omnetpp.ini')
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count(), help='concurrent runs (default: one per core)')
+    parser.add_argument('--binary', default=default_binary(), help='the simulation binary')
+    parser.add_argument('--results', default=os.path.join(HERE, 'results'), help='the result directory')
+    parser.add_argument('--summary', default=None, help='the summary file (default: <results>/summary.csv)')
+    parser.add_argument('--runs', help='a run filter, e.g., 0..9, instead of every run')
+    parser.add_argument('options', nargs='*', help='extra options for the simulation, after --')
+    args = parser.parse_args()
+    args.binary = os.path.abspath(args.binary)
+    args.results = os.path.abspath(args.results)
+    args.summary = args.summary or os.path.join(args.results, 'summary.csv')
+    os.makedirs(args.results, exist_ok=True)
+    jobs = []
+    for config in args.config:
+        if args.runs:
+            first, _, last = args.runs.partition('..')
+            numbers = range(int(first), int(last or first) + 1)
+        else:
+            numbers = range(count_runs(args, config))
+        jobs += [(config, number) for number in numbers]
+    sys.stderr.write('%d runs on %d processes\n' % (len(jobs), args.jobs))
+    failed = 0
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        futures = [pool.submit(run, args, config, number) for config, number in jobs]
+        for done, future in enumerate(concurrent.futures.as_completed(futures), 1):
+            config, number, status, seconds = future.result()
+            failed += status != 0
+            sys.stderr.write('[%d/%d] %s #%d %s in %.1fs\n'
+                             % (done, len(jobs), config, number, 'failed' if status else 'done', seconds))
+    rows = summarize(args, args.config)
+    sys.stderr.write('%d rows written to %s, %d runs failed\n' % (rows, args.summary, failed))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,75 @@
+#include "AllPairsRouting.h"
+
+#include <algorithm>
+
+#include "WorkStealingPool.h"
+
+std::map<const CsrGraph*, std::weak_ptr<const AllPairsRouting>>
+  AllPairsRouting::forests;
+
+AllPairsRouting::AllPairsRouting(
+  const std::shared_ptr<const CsrGraph>& g, QueueKind queue, int threads
+)
+  : graph(g)
+  , n(g->size())
+  , prev(std::size_t(n) * n)
+  , port(std::size_t(n) * n)
+  , distance(std::size_t(n) * n)
+{
+  // The pool outlives the forests, it is rebuilt when the threads change
+  static std::unique_ptr<WorkStealingPool> pool;
+  static int poolThreads;
+  if (!pool || poolThreads != threads) {
+    pool.reset();
+    pool.reset(new WorkStealingPool(threads));
+    poolThreads = threads;
+  }
+  pool->parallelFor(n, [&](int s) {
+    std::size_t offset = std::size_t(s) * n;
+    shortestPaths(
+      queue, *graph, s, &prev[offset], &port[offset], &distance[offset]
+    );
+  });
+}
+
+AllPairsRouting::AllPairsRouting(
+  int n, std::vector<int> sources, std::vector<int> prev,
+  std::vector<int> port, std::vector<double> distance
+)
+  : n(n)
+  , sources(std::move(sources))
+  , prev(std::move(prev))
+  , port(std::move(port))
+  , distance(std::move(distance))
+{ }
+
+bool AllPairsRouting::contains(int source) const {
+  if (sources.empty())
+    return source >= 0 && source < n && !prev.empty();
+  return std::binary_search(sources.begin(), sources.end(), source);
+}
+
+RoutingRow AllPairsRouting::row(int source) const {
+  std::size_t index = source;
+  if (!sources.empty())
+    index = std::lower_bound(sources.begin(), sources.end(), source)
+          - sources.begin();
+  std::size_t offset = index * n;
+  return RoutingRow{&prev[offset], &port[offset], &distance[offset], n};
+}
+
+std::shared_ptr<const AllPairsRouting> AllPairsRouting::obtain(
+  const std::shared_ptr<const CsrGraph>& graph, QueueKind queue, int threads
+) {
+  std::shared_ptr<const AllPairsRouting> forest;
+  auto cached = forests.find(graph.get());
+  if (cached != forests.end())
+    forest = cached->second.lock();
+  if (!forest) {
+    for (auto it = forests.begin(); it != forests.end(); )
+      it = it->second.expired() ? forests.erase(it) : std::next(it);
+    forest = std::make_shared<const AllPairsRouting>(graph, queue, threads);
+    forests[graph.get()] = forest;
+  }
+  return forest;
+}
@@ -0,0 +1,95 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#if !defined(ALL_PAIRS_ROUTING_H)
+#define ALL_PAIRS_ROUTING_H
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "CsrGraph.h"
+#include "RoutingTable.h"
+#include "ShortestPaths.h"
+
+/** @brief The routing tables of every node of a network, i.e., the forest of
+ *  shortest-path trees of a graph. Tables are stored as three matrices of n
+ *  columns, a row per source. Rows are computed on a work-stealing pool,
+ *  each task runs the single-source engine for one source. A forest may
+ *  also hold the rows of some sources only, e.g., the ones a subtree
+ *  received from another partition.
+ *  @author A.G. Medrano-Chavez
+ */
+class AllPairsRouting {
+private:
+  /** @brief The graph this object routes, it is kept alive by this object */
+  std::shared_ptr<const CsrGraph> graph;
+  /** @brief The number of nodes */
+  int n;
+  /** @brief The sorted sources whose rows are stored, empty if all are */
+  std::vector<int> sources;
+  std::vector<int> prev;
+  std::vector<int> port;
+  std::vector<double> distance;
+  /** @brief The forests computed so far, indexed by graph. Every node of a
+   *  network receives the same graph object, so the first node asking for the
+   *  forest of a graph computes it and the other ones share it */
+  static std::map<const CsrGraph*, std::weak_ptr<const AllPairsRouting>> forests;
+public:
+  /** @brief Computes the routing tables of every node of a graph
+   *  @param graph The network graph
+   *  @param queue The priority queue of the shortest-path engine
+   *  @param threads The number of threads, zero means one per core
+   */
+  AllPairsRouting(
+    const std::shared_ptr<const CsrGraph>& graph, QueueKind queue, int threads
+  );
+  /** @brief Builds a forest holding the rows of some sources
+   *  @param n The number of nodes
+   *  @param sources The sorted sources
+   *  @param prev, port, distance Their rows, in the order of sources
+   */
+  AllPairsRouting(
+    int n, std::vector<int> sources, std::vector<int> prev,
+    std::vector<int> port, std::vector<double> distance
+  );
+  /** @brief Returns the number of nodes */
+  int size() const { return n; }
+  /** @brief Tells whether the row of a node is stored */
+  bool contains(int source) const;
+  /** @brief Returns the routing table of a node, which must be stored */
+  RoutingRow row(int source) const;
+  /** @brief Returns the forest of a graph, computing it if no node has
+   *  asked for it before
+   *  @param graph The network graph
+   *  @param queue The priority queue of the shortest-path engine
+   *  @param threads The number of threads, zero means one per core
+   */
+  static std::shared_ptr<const AllPairsRouting> obtain(
+    const std::shared_ptr<const CsrGraph>& graph, QueueKind queue, int threads
+  );
+};
+
+/** @brief The routing tables shipped to a subtree, i.e., the rows of a forest
+ *  belonging to the nodes of the subtree. Within a partition the rows are
+ *  not copied, forest is the one of the sender, but a receiver only reads
+ *  the rows of sources. Across partitions only those rows are packed, so
+ *  forest holds them alone */
+struct RoutingBundle {
+  std::shared_ptr<const AllPairsRouting> forest;
+  std::vector<int> sources;
+};
+
+#endif // ALL_PAIRS_ROUTING_H
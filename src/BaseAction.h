@@ -16,19 +16,33 @@
 #if !defined(BASE_ACTION_H)
 #define BASE_ACTION_H
 
-#define New_Action(CLASSNAME) (std::make_shared<CLASSNAME>(this))
+#include <omnetpp.h>
 
-class BaseAction {
-private:
+class BaseNode;
+
+/** @brief An action that is not bound to any node: it runs on the node it
+ *  receives, so a single handler serves every instance of a node class */
+typedef void (*ActionHandler)(BaseNode*, omnetpp::cMessage*);
+
+/** @brief An entry of a rule table: the handler of an action and its name */
+struct ActionEntry {
+  ActionHandler run;
   const char* name;
+};
+
+/** @brief Base class of actions. An action is a functor holding the node it
+ *  acts on; it is built on the stack when a rule fires, so actions carry no
+ *  state between events. Derived classes define operator() taking a pointer
+ *  to the message class of their event kind, see ProtocolSpec.h.
+ *  @author A.G. Medrano-Chavez
+ */
+template <typename Node>
+class Action {
+protected:
+  Node* ap;
 public:
-  /** @brief Default constructor: sets the value of member name */
-  BaseAction(const char* n) : name(n) { }
-  /** @brief Abstract member function that derived class overloads to act as
-   *  functors */
-  virtual void operator()(omnetpp::cMessage*) = 0;
-  /** @brief Returns the name of the action */
-  virtual const char* getName() { return name; }
+  typedef Node NodeType;
+  Action(Node* ptr) : ap(ptr) { }
 };
 
 #endif // BASE_ACTION_H
@@ -2,11 +2,14 @@
 
 Register_Abstract_Class(BaseNode);
 
+BaseNode::NetworkMetrics BaseNode::network;
+omnetpp::simsignal_t BaseNode::statusSignal = registerSignal("status");
+
 omnetpp::cMessage* BaseNode::localBroadcast(omnetpp::cMessage* msg) {
   int n = gateSize(out);
   if (msg && n > 0) {
     for (int i = 0; i < n -1; i++)
-      send(msg->dup(), out, i);
+      send(replicate(msg), out, i);
     send(msg, out, n-1);
   }
   return msg;
@@ -19,8 +22,8 @@ omnetpp::cMessage* BaseNode::localFlooding(omnetpp::cMessage* msg) {
     if (msg && n > 0) {
       for (int i = 0; i < n; i++)
         if (i != senderID)
-          send(msg->dup(), out, i);
-      delete msg;
+          send(replicate(msg), out, i);
+      recycle(msg);
     }
     return msg;
   }
@@ -38,11 +41,11 @@ omnetpp::cMessage* BaseNode::localMulticast(
   if (msg) {
     if (!destination.empty()) {
       for (auto&& port : destination)
-        send(msg->dup(), out, port);
-      delete msg;
+        send(replicate(msg), out, port);
+      recycle(msg);
     }
     else
-      delete msg;
+      recycle(msg);
   }
   return msg;
 }
@@ -81,41 +84,123 @@ void BaseNode::setTimer(omnetpp::simtime_t t) {
 }
 
 void BaseNode::handleMessage(omnetpp::cMessage* ev) {
-  EventKind event = static_cast<EventKind>(ev->getKind());
-  pair.set(status, event);
-  auto it = protocol.find(pair);
-  if (it != protocol.end()) {
-  EV_INFO << "Node[" << getIndex() << "] meets rule ("
-          << it->first.getStatus().str() << ", " 
-          << ev->getName() << ") -> "
-          << it->second->getName() << '\n';
-    (*protocol[pair])(ev);
+  int kind = ev->getKind();
+  // Kinds outside the table are left to nil(), as RuleTable::find() does
+  if (metrics && !ev->isSelfMessage()
+      && kind >= 0 && kind < EventKind::EVENT_KINDS)
+    receivedCount[kind]++;
+  const ActionEntry& action = protocol->find(status, kind);
+  if (action.run) {
+    EV_INFO << "Node[" << getIndex() << "] meets rule ("
+            << status.str() << ", " 
+            << ev->getName() << ") -> "
+            << action.name << '\n';
+    action.run(this, ev);
   }
   else
     nil(ev);
+  if (metrics && status != lastStatus) {
+    trackStatus();
+    emit(statusSignal, status.get());
+  }
 }
 
-void BaseNode::addRule(
-  const Status& s, 
-  EventKind e,
-  const std::shared_ptr<BaseAction>& action
-) {
-  pair.set(s, e);
-  protocol[pair] = action;
+void BaseNode::trackStatus() {
+  omnetpp::simtime_t now = omnetpp::simTime();
+  statusTime[lastStatus.index()] += now - lastStatusChange;
+  lastStatus = status;
+  lastStatusChange = now;
 }
 
-int BaseNode::getLinkWeight(const char* name, int index) {
-  auto edge = dynamic_cast<Edge*>(gate(name, index)->getChannel());
-  return edge ->getWeight();
+void BaseNode::initializeMetrics() {
+  metrics = par("metrics").boolValue();
+  lastStatus = status;
+  lastStatusChange = omnetpp::simTime();
+  if (metrics)
+    emit(statusSignal, status.get());
 }
 
-int BaseNode::getLinkWeight(omnetpp::cGate* gate, int index) {
-  auto edge = dynamic_cast<Edge*>(gate);
-  return edge->getWeight();
+void BaseNode::finish() {
+  if (metrics) {
+    trackStatus();
+    long sent = 0, received = 0;
+    for (int kind = 0; kind < EventKind::EVENT_KINDS; kind++) {
+      std::string name(eventKindName(kind));
+      if (sentCount[kind] > 0) {
+        recordScalar(("sent:" + name).c_str(), sentCount[kind]);
+        addNetworkScalar("sent:" + name, sentCount[kind]);
+      }
+      if (receivedCount[kind] > 0)
+        recordScalar(("received:" + name).c_str(), receivedCount[kind]);
+      sent += sentCount[kind];
+      received += receivedCount[kind];
+    }
+    recordScalar("sent", sent);
+    recordScalar("received", received);
+    recordScalar("sentBytes", sentBytes);
+    addNetworkScalar("sent", sent);
+    addNetworkScalar("sentBytes", sentBytes);
+    // The size of the network, to compare the counts with the bounds
+    addNetworkScalar("nodes", 1);
+    addNetworkScalar("links", neighborhoodSize / 2.0);
+    for (int i = 0; i < Status::COUNT; i++)
+      if (statusTime[i] > SIMTIME_ZERO) {
+        Status s(Status::Code(i - 1));
+        recordScalar(
+          (std::string("time:") + s.str()).c_str(), statusTime[i], "s"
+        );
+      }
+  }
+  if (++network.finished == network.nodes) {
+    omnetpp::cModule* owner = getParentModule();
+    for (auto& scalar : network.scalars)
+      owner->recordScalar(scalar.first.c_str(), scalar.second);
+    network.scalars.clear();
+    network.finished = 0;
+  }
+}
+
+long BaseNode::payloadSize(const omnetpp::cMessage* msg) const {
+  if (msg->isPacket())
+    return static_cast<const omnetpp::cPacket*>(msg)->getByteLength();
+  return 0;
+}
+
+void BaseNode::maxNetworkScalar(const std::string& name, double value) {
+  auto it = network.scalars.find(name);
+  if (it == network.scalars.end())
+    network.scalars.emplace(name, value);
+  else if (it->second < value)
+    it->second = value;
+}
+
+double BaseNode::getLinkWeight(const char* name, int index) {
+  return getLinkWeight(gate(name, index));
+}
+
+double BaseNode::getLinkWeight(omnetpp::cGate* gate) {
+  omnetpp::cChannel* channel = gate->getChannel();
+  if (!channel || !channel->hasPar("weight"))
+    throw omnetpp::cRuntimeError(
+      "Node[%d]: the link of gate %s has no weight", getIndex(),
+      gate->getFullName()
+    );
+  // The parameter is read instead of Edge::getWeight(), so the weight is
+  // right even if the channel is not initialized yet
+  return channel->par("weight").doubleValue();
+}
+
+void BaseNode::handleLinkWeightChange(int port, double weight) {
+  if (port < (int)linkWeights.size())
+    linkWeights[port] = weight;
 }
 
 void BaseNode::initializeNeighborhood() {
   neighborhoodSize = gateSize(out);
-  for (int i = 0; i < neighborhoodSize; i++)
+  neighborhood.clear();
+  linkWeights.clear();
+  for (int i = 0; i < neighborhoodSize; i++) {
     neighborhood.push_back(gate(out, i));
+    linkWeights.push_back(getLinkWeight(neighborhood[i]));
+  }
 }
\ No newline at end of file
@@ -17,13 +17,17 @@
 #define BASENODE_H
 
 #include <omnetpp.h>
+#include <array>
 #include <vector>
-#include <unordered_map>
 #include <functional>
+#include <map>
 #include <memory>
+#include <string>
 
-#include "Enabler.h"
+#include "Status.h"
+#include "Event.h"
 #include "BaseAction.h"
+#include "RuleTable.h"
 #include "Edge.h"
 
 class BaseNode : public omnetpp::cSimpleModule {
@@ -33,28 +37,52 @@ private:
   /** @brief A timer that rings after sometime. It is set by the setTimer()
    *  method */
   Timeout* timeout; 
-  /** @brief This object is used tu add protocol rules */
-  Enabler pair;
   /** @brief The set of rules B(x) this node obeys. The structure of a rule is:
    *  (status, event) -> action. The elements of the pair (status, event) 
    *  corresponds to objects of kind Status and EventKind, properly. Note that
    *  both the spontaneous impulse and the ringing of a timer are produced by 
    *  self-messages, thus the second element (the event) is a message. The 
-   *  action is a functor that the user of this class must register in 
-   *  the initialize method as follows:
+   *  action is a functor that the user of this class must list in the
+   *  protocol specification of the class:
    * 
-   *  protocol[enabler] = action,
-   * 
-   *  where the enabler is an object of kind Enabler and action is a functor
-   *  extending the abstract class Action. Each action must be defined by the 
-   *  user of this class in the Action.cc file
+   *  Rule<status, event, ActionClass>,
    * 
+   *  where ActionClass extends the template Action. The table generated from
+   *  the specification is shared by every node of the class, see setRules().
    */
-  std::unordered_map<Enabler, std::shared_ptr<BaseAction>, EnablerHasher> protocol;
+  const RuleTable* protocol;
   /** @brief Structure storing gate pointers. Communications are efficient7
    *  when they are used.
   */
   std::vector<omnetpp::cGate*> neighborhood;
+  /** @brief The weight of the link connected to each port, read once by
+   *  initializeNeighborhood() and kept up to date by the links */
+  std::vector<double> linkWeights;
+  /** @brief Whether this node keeps the counters below, see the metrics
+   *  parameter. Disabled nodes pay a single branch per message */
+  bool metrics = false;
+  /** @brief The number of messages sent and received, indexed by kind */
+  std::array<long, EventKind::EVENT_KINDS> sentCount{}, receivedCount{};
+  /** @brief The number of payload bytes sent, see payloadSize() */
+  long sentBytes = 0;
+  /** @brief The time spent in each status, indexed by Status::index() */
+  std::array<omnetpp::simtime_t, Status::COUNT> statusTime{};
+  /** @brief The status of the last event and the time it was entered */
+  Status lastStatus;
+  omnetpp::simtime_t lastStatusChange;
+  /** @brief The metrics of the whole network. Nodes add to the scalars while
+   *  running and in finish(), the last node to finish records them on the
+   *  network module. Parallel runs record one set per partition */
+  struct NetworkMetrics {
+    /** @brief The number of live nodes and the number of finished ones */
+    int nodes = 0, finished = 0;
+    /** @brief The scalars by name, ordered so result files are stable */
+    std::map<std::string, double> scalars;
+  };
+  static NetworkMetrics network;
+  static omnetpp::simsignal_t statusSignal;
+  /** @brief Charges the time since the last status change to the old status */
+  void trackStatus();
 protected:
   /** @brief The current status of this node */
   Status status;
@@ -64,12 +92,23 @@ protected:
   const char* out = "port$o";
 public:
   /** @brief Default constructor */
-  BaseNode() : wakeUp(nullptr), timeout(nullptr), pair(), status() { }
+  BaseNode()
+    : wakeUp(nullptr)
+    , timeout(nullptr)
+    , protocol(nullptr)
+    , status()
+  {
+    if (network.nodes++ == 0) {
+      network.finished = 0;
+      network.scalars.clear();
+    }
+  }
   /** @brief Default destructor which tries to delete 
    *  the event "spontaneously" */
   virtual ~BaseNode() { 
     cancelAndDelete(wakeUp); 
     cancelAndDelete(timeout);
+    network.nodes--;
   }
   /** @brief Sets the initial status of protocols according to its role. In 
    *  addition, records the rules this node obeys.
@@ -79,6 +118,44 @@ public:
    *  If the action is undefined, then nil is invoke.
    */
   virtual void handleMessage(omnetpp::cMessage*);
+  /** @brief Records the message counts, the bytes and the time spent in each
+   *  status of this node. The last node to finish records the network-wide
+   *  scalars as well. Subclasses call it from their finish()
+   */
+  virtual void finish();
+  using omnetpp::cSimpleModule::send;
+  /** @brief Sends a message through a port, counting it by kind. Every
+   *  protocol message leaves through this overload
+   *  @param first - a valid pointer to a message
+   *  @param second - the name of the gate vector
+   *  @param third - the index of the port
+  */
+  void send(omnetpp::cMessage* msg, const char* gateName, int index = -1) {
+    if (metrics) {
+      int kind = msg->getKind();
+      if (kind >= 0 && kind < EventKind::EVENT_KINDS)
+        sentCount[kind]++;
+      sentBytes += payloadSize(msg);
+    }
+    omnetpp::cSimpleModule::send(msg, gateName, index);
+  }
+  /** @brief Returns the number of bytes a message carries. Packets report
+   *  their length, protocols give the size of the fields of their messages
+   *  @param first - a valid pointer to a message
+  */
+  virtual long payloadSize(const omnetpp::cMessage* msg) const;
+  /** @brief Adds a value to a network-wide scalar
+   *  @param first - the name of the scalar
+   *  @param second - the value to add
+  */
+  static void addNetworkScalar(const std::string& name, double value) {
+    network.scalars[name] += value;
+  }
+  /** @brief Raises a network-wide scalar to a value if it is lower
+   *  @param first - the name of the scalar
+   *  @param second - the value
+  */
+  static void maxNetworkScalar(const std::string& name, double value);
   /** @brief Broadcasts a message to N(x) 
    *  @param first - a valid pointer to a message
    *  @return a null pointer to the received message
@@ -98,6 +175,21 @@ public:
   omnetpp::cMessage* localMulticast(
     omnetpp::cMessage*, const std::vector<int>&
   );
+  /** @brief Returns a copy of a message to be sent through another port.
+   *  The broadcast helpers call it instead of dup(), so nodes may serve the
+   *  copies from their message pools. Payloads held by shared pointers are
+   *  shared by the copies, only the envelope is copied.
+   *  @param first - a valid pointer to a message
+   *  @return a copy of the message
+  */
+  virtual omnetpp::cMessage* replicate(omnetpp::cMessage* msg) {
+    return msg->dup();
+  }
+  /** @brief Disposes a message this node no longer needs. The broadcast
+   *  helpers call it instead of delete, so nodes may recycle messages.
+   *  @param first - a valid pointer to a message
+  */
+  virtual void recycle(omnetpp::cMessage* msg) { delete msg; }
   /** @brief Displays a string in the simulation canvas */
   virtual void displayInfo(const char* info) const{
     getDisplayString().setTagArg("t", 0, info);
@@ -143,24 +235,46 @@ public:
    *  @param first - The time to trigger a timeout event from this moment
   */
   virtual void setTimer(omnetpp::simtime_t);
-  /** @brief Adds new rule to the protocol this node obeys. In order to add
-   *  an action, use the New_Action macro since this method needs a shared
-   *  pointer pointing to a valid action functor.
+  /** @brief Sets the rules this node obeys. The table is usually a static
+   *  object built once per class in initialize() as follows:
+   *
+   *  static const RuleTable rules(&NodeClass::Protocol::addRules);
+   *  setRules(&rules);
   */
-  virtual void addRule(const Status&, EventKind ev, const std::shared_ptr<BaseAction>&);
-  /** @brief Returns the weight of the link connected to a given port.
-   *  @param first - The name of the port either "in" or "out".
-   *  @param second - The index of the port (default zero).
+  void setRules(const RuleTable* rules) { protocol = rules; }
+  /** @brief Returns the weight of the link connected to a given port of the
+   *  output gate vector, it is served from the cache of link weights.
+   *  @param first - The index of the port.
   */
-  virtual int getLinkWeight(const char*, int index = 0);
+  double getLinkWeight(int port) const { return linkWeights[port]; }
   /** @brief Returns the weight of the link connected to a given port.
    *  @param first - The name of the port either "in" or "out".
    *  @param second - The index of the port (default zero).
   */
-  virtual int getLinkWeight(omnetpp::cGate*, int index = 0);
+  virtual double getLinkWeight(const char*, int index = 0);
+  /** @brief Returns the node at the other end of a given port.
+   *  @param first - The index of the port.
+  */
+  omnetpp::cModule* getNeighbor(int port) const {
+    return neighborhood[port]->getPathEndGate()->getOwnerModule();
+  }
+  /** @brief Returns the weight of the link connected to a given gate.
+   *  @param first - The gate.
+  */
+  virtual double getLinkWeight(omnetpp::cGate*);
+  /** @brief Updates the cached weight of a link whose weight changed at
+   *  runtime. Edge calls it on the node owning the source gate.
+   *  @param first - The index of the port.
+   *  @param second - The new weight.
+  */
+  virtual void handleLinkWeightChange(int port, double weight);
+  /** @brief Reads the metrics parameter and starts timing the initial
+   *  status. Invoke this method in initialize() once the status is set
+  */
+  virtual void initializeMetrics();
   /** @brief Initializes data about N(x), especifically a gate vector used
-   *  to perform efficent communications and the neighborhood size variable.
-   *  Invoke this method in initialize()
+   *  to perform efficent communications, the weight of each link and the
+   *  neighborhood size variable. Invoke this method in initialize()
   */
  virtual void initializeNeighborhood();
 };
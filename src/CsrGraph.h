@@ -0,0 +1,100 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#if !defined(CSR_GRAPH_H)
+#define CSR_GRAPH_H
+
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/** @brief A weighted directed graph in compressed sparse row format. The arcs
+ *  leaving vertex v are stored in the positions begin(v)..end(v)-1 of two
+ *  parallel arrays, one holding the neighbor IDs and the other the weights.
+ *  Arcs keep the order in which they are given, so when each node reports
+ *  its neighbors by port number, arc begin(v)+i is reached through port i.
+ *  @author A.G. Medrano-Chavez
+ */
+class CsrGraph {
+private:
+  /** @brief The first arc of each vertex, offsets[n] is the number of arcs */
+  std::vector<int> offsets;
+  /** @brief The head of each arc */
+  std::vector<int> targets;
+  /** @brief The weight of each arc */
+  std::vector<double> weights;
+public:
+  /** @brief Builds an empty graph */
+  CsrGraph() : offsets(1, 0) { }
+  /** @brief Builds a graph of n vertices from a range of <tail, head, weight>
+   *  tuples by a counting sort: the first pass counts the out-degree of each
+   *  vertex, the second one places every arc in its row.
+   *  @param n The number of vertices
+   *  @param first The first tuple of the range
+   *  @param last The end of the range
+   */
+  template <typename Iterator>
+  CsrGraph(int n, Iterator first, Iterator last) : offsets(n + 1, 0) {
+    using std::get;
+    for (auto it = first; it != last; ++it)
+      offsets[get<0>(*it) + 1]++;
+    for (int v = 0; v < n; v++)
+      offsets[v + 1] += offsets[v];
+    targets.resize(offsets[n]);
+    weights.resize(offsets[n]);
+    std::vector<int> next(offsets.begin(), offsets.end() - 1);
+    for (auto it = first; it != last; ++it) {
+      int e = next[get<0>(*it)]++;
+      targets[e] = get<1>(*it);
+      weights[e] = get<2>(*it);
+    }
+  }
+  /** @brief Builds a graph from its arrays, e.g., after receiving them from
+   *  another process
+   *  @param offsets The first arc of each vertex plus the number of arcs
+   *  @param targets The head of each arc
+   *  @param weights The weight of each arc
+   */
+  CsrGraph(
+    std::vector<int> offsets, std::vector<int> targets,
+    std::vector<double> weights
+  )
+    : offsets(std::move(offsets))
+    , targets(std::move(targets))
+    , weights(std::move(weights))
+  { }
+  /** @brief Returns the number of vertices */
+  int size() const { return offsets.size() - 1; }
+  /** @brief Returns the number of arcs */
+  int arcs() const { return targets.size(); }
+  /** @brief Returns the index of the first arc leaving v */
+  int begin(int v) const { return offsets[v]; }
+  /** @brief Returns the index past the last arc leaving v */
+  int end(int v) const { return offsets[v + 1]; }
+  /** @brief Returns the number of arcs leaving v */
+  int degree(int v) const { return offsets[v + 1] - offsets[v]; }
+  /** @brief Returns the head of arc e */
+  int target(int e) const { return targets[e]; }
+  /** @brief Returns the weight of arc e */
+  double weight(int e) const { return weights[e]; }
+  /** @brief Returns the first arc of every vertex */
+  const std::vector<int>& getOffsets() const { return offsets; }
+  /** @brief Returns the heads of all arcs */
+  const std::vector<int>& getTargets() const { return targets; }
+  /** @brief Returns the weights of all arcs */
+  const std::vector<double>& getWeights() const { return weights; }
+};
+
+#endif // CSR_GRAPH_H
@@ -0,0 +1,79 @@
+//
+// Generated file, do not edit! Created by nedtool 5.6 from DataMsg.msg.
+//
+
+#ifndef __DATAMSG_M_H
+#define __DATAMSG_M_H
+
+#if defined(__clang__)
+#  pragma clang diagnostic ignored "-Wreserved-id-macro"
+#endif
+#include <omnetpp.h>
+
+// nedtool version check
+#define MSGC_VERSION 0x0506
+#if (MSGC_VERSION!=OMNETPP_VERSION)
+#    error Version mismatch! Probably this file was generated by an earlier version of nedtool: 'make clean' should help.
+#endif
+
+
+
+// cplusplus {{
+  #include "Event.h"
+// }}
+
+/**
+ * Class generated from <tt>DataMsg.msg:5</tt> by nedtool.
+ * <pre>
+ * packet DataMsg
+ * {
+ *     name = "data";
+ *     kind = EventKind::DATA;
+ *     int source;         // The uid of the node generating the packet
+ *     int destination;    // The uid of the node sinking the packet
+ *     int hops;           // The number of links traversed so far
+ *     double pathWeight;  // The weight of the links traversed so far
+ * }
+ * </pre>
+ */
+class DataMsg : public ::omnetpp::cPacket
+{
+  protected:
+    int source;
+    int destination;
+    int hops;
+    double pathWeight;
+
+  private:
+    void copy(const DataMsg& other);
+
+  protected:
+    // protected and unimplemented operator==(), to prevent accidental usage
+    bool operator==(const DataMsg&);
+
+  public:
+    DataMsg(const char *name=nullptr, short kind=0);
+    DataMsg(const DataMsg& other);
+    virtual ~DataMsg();
+    DataMsg& operator=(const DataMsg& other);
+    virtual DataMsg *dup() const override {return new DataMsg(*this);}
+    virtual void parsimPack(omnetpp::cCommBuffer *b) const override;
+    virtual void parsimUnpack(omnetpp::cCommBuffer *b) override;
+
+    // field getter/setter methods
+    virtual int getSource() const;
+    virtual void setSource(int source);
+    virtual int getDestination() const;
+    virtual void setDestination(int destination);
+    virtual int getHops() const;
+    virtual void setHops(int hops);
+    virtual double getPathWeight() const;
+    virtual void setPathWeight(double pathWeight);
+};
+
+inline void doParsimPacking(omnetpp::cCommBuffer *b, const DataMsg& obj) {obj.parsimPack(b);}
+inline void doParsimUnpacking(omnetpp::cCommBuffer *b, DataMsg& obj) {obj.parsimUnpack(b);}
+
+
+#endif // ifndef __DATAMSG_M_H
+
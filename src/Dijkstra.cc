@@ -2,15 +2,112 @@
 
 Define_Module(Dijkstra);
 
+std::vector<int> Dijkstra::destinations;
+int Dijkstra::population = 0;
+omnetpp::simsignal_t Dijkstra::latencySignal = registerSignal("latency");
+omnetpp::simsignal_t Dijkstra::hopsSignal = registerSignal("hops");
+omnetpp::simsignal_t Dijkstra::stretchSignal = registerSignal("stretch");
+
+Dijkstra::~Dijkstra() {
+  population--;
+  for (auto msg : pending)
+    delete msg;
+}
+
 void Dijkstra::initialize() {
   MegaMerger::initialize();
   source = par("source").boolValue();
   destination = par("destination").boolValue();
-  addRule(Status::CONNECTING, EventKind::TERMINATION, New_Action(StartingConvergecast));
-  addRule(Status::FOLLOWER, EventKind::NEIGHBORHOOD, New_Action(ConvergecastingNeighborhood));
-  addRule(Status::LEADER, EventKind::NEIGHBORHOOD, New_Action(ConvergecastingNeighborhood));
-  addRule(Status::PROCESSING, EventKind::GRAPH, New_Action(ComputingRT));
-  addRule(Status::ROUTING, EventKind::DATA, New_Action(Routing));
+  std::string queue = par("queue").stdstringValue();
+  if (queue == "binary")
+    queueKind = QueueKind::BINARY_HEAP;
+  else if (queue == "pairing")
+    queueKind = QueueKind::PAIRING_HEAP;
+  else if (queue == "radix")
+    queueKind = QueueKind::RADIX_HEAP;
+  else
+    throw omnetpp::cRuntimeError("Dijkstra: unknown queue \"%s\"", queue.c_str());
+  std::string mode = par("routingMode").stdstringValue();
+  if (mode == "local")
+    routingMode = RoutingMode::LOCAL;
+  else if (mode == "shared")
+    routingMode = RoutingMode::SHARED;
+  else if (mode == "leader")
+    routingMode = RoutingMode::LEADER;
+  else
+    throw omnetpp::cRuntimeError("Dijkstra: unknown routing mode \"%s\"", mode.c_str());
+  threads = par("threads").intValue();
+  maxForestNodes = par("maxForestNodes").intValue();
+  dumpTarget = par("dump").stdstringValue();
+  graphPool.setCapacity(par("poolCapacity").intValue());
+  packets = par("packets").intValue();
+  // Kept sorted for pickDestination(), nodes initialize by ascending index,
+  // so the insertion point is usually the end
+  if (destination)
+    destinations.insert(
+      std::upper_bound(destinations.begin(), destinations.end(), getIndex()),
+      getIndex()
+    );
+  static const RuleTable rules(&Protocol::addRules);
+  setRules(&rules);
+}
+
+void Dijkstra::finish() {
+  if (routingTime >= SIMTIME_ZERO)
+    recordScalar("routingTime", routingTime, "s");
+  if (generated > 0 || delivered > 0 || forwarded > 0 || dropped > 0) {
+    recordScalar("generated", generated);
+    recordScalar("delivered", delivered);
+    recordScalar("forwarded", forwarded);
+    recordScalar("dropped", dropped);
+    addNetworkScalar("generated", generated);
+    addNetworkScalar("delivered", delivered);
+    addNetworkScalar("forwarded", forwarded);
+    addNetworkScalar("dropped", dropped);
+    // Packets sunk per second of simulated time since the table was ready
+    omnetpp::simtime_t routed = omnetpp::simTime() - routingTime;
+    if (routingTime >= SIMTIME_ZERO && routed > SIMTIME_ZERO)
+      recordScalar("throughput", delivered / SIMTIME_DBL(routed), "packets/s");
+  }
+  MegaMerger::finish();
+  recordScalar("graphPoolHits", graphPool.getHits());
+  recordScalar("graphPoolMisses", graphPool.getMisses());
+}
+
+long Dijkstra::payloadSize(const omnetpp::cMessage* msg) const {
+  const long entrySize = 2 * sizeof(int) + sizeof(double);
+  if (msg->getKind() == EventKind::NEIGHBORHOOD) {
+    auto nMsg = static_cast<const NeighborhoodMsg*>(msg);
+    auto& entries = nMsg->getN();
+    return 2 * sizeof(int) + (entries ? entries->size() * entrySize : 0);
+  }
+  if (msg->getKind() == EventKind::GRAPH) {
+    auto graphMsg = static_cast<const GraphMsg*>(msg);
+    auto& m = graphMsg->getM();
+    auto& rows = graphMsg->getRows();
+    long size = 0;
+    if (m)
+      size += (m->size() + 1) * sizeof(int)
+            + m->arcs() * (sizeof(int) + sizeof(double));
+    // The rows of a subtree, i.e., a routing table per node
+    if (rows)
+      size += rows->sources.size() * (sizeof(int) + networkSize * entrySize);
+    return size;
+  }
+  return MegaMerger::payloadSize(msg);
+}
+
+omnetpp::cMessage* Dijkstra::replicate(omnetpp::cMessage* msg) {
+  if (msg->getKind() == EventKind::GRAPH)
+    return graphPool.copy(*static_cast<GraphMsg*>(msg));
+  return MegaMerger::replicate(msg);
+}
+
+void Dijkstra::recycle(omnetpp::cMessage* msg) {
+  if (msg->getKind() == EventKind::GRAPH)
+    graphPool.release(static_cast<GraphMsg*>(msg));
+  else
+    MegaMerger::recycle(msg);
 }
 
 void Dijkstra::sendNeighborhood(NeighborhoodMsg* msg) {
@@ -19,10 +116,10 @@ void Dijkstra::sendNeighborhood(NeighborhoodMsg* msg) {
     msg = new NeighborhoodMsg;
   msg->setSubtreeSize(networkSize);
   msg->setSender(uid);
-  for (auto& neighbor : neighborCache) {
+  for (int i = 0; i < neighborCache.size(); i++) {
     std::get<0>(entry) = uid;
-    std::get<1>(entry) = std::get<MegaMerger::Index::NID>(neighbor);
-    std::get<2>(entry) = std::get<MegaMerger::Index::WEIGHT>(neighbor);
+    std::get<1>(entry) = neighborCache.nid(i);
+    std::get<2>(entry) = neighborCache.weight(i);
     n->push_back(entry);
   }
   msg->setN(n);
@@ -31,99 +128,225 @@ void Dijkstra::sendNeighborhood(NeighborhoodMsg* msg) {
 
 void Dijkstra::sendGraph(GraphMsg* msg) {
   if (!msg) {
-    msg = new GraphMsg;
-    msg->setM(graph);
+    msg = graphPool.acquire();
+    // The rows carry the routing tables, the graph is of no use then
+    msg->setM(routingMode == RoutingMode::LEADER ? nullptr : graph);
+    msg->setRows(nullptr);
+  }
+  if (routingMode == RoutingMode::LEADER) {
+    for (auto port : children) {
+      auto rows = std::make_shared<RoutingBundle>();
+      rows->forest = forest;
+      rows->sources = subtrees[port];
+      auto copy = graphPool.copy(*msg);
+      copy->setRows(rows);
+      send(copy, out, port);
+    }
+    recycle(msg);
   }
-  localMulticast(msg, children);
+  else
+    localMulticast(msg, children);
 }
 
 void Dijkstra::computeGraph() {
-  graph = std::make_shared<std::vector<MatrixEntry>>(networkSize);
-  MatrixEntry row;
-  std::pair<int, double> element;
-  for (auto& item : (*n)) {
-    element.first = std::get<1>(item);  //dest
-    element.second = std::get<2>(item); //weight
-    (*graph)[std::get<0>(item)].push_back(element);
-  }
+  graph = std::make_shared<const CsrGraph>(networkSize, n->begin(), n->end());
 }
 
 void Dijkstra::computeRoutingTable() {
-  using std::get;
-  std::vector<int> unvisited(networkSize);
-  RTEntry rtEntry;
-  //initialize
-  for (int i = 0; i < networkSize; i++) {
-    unvisited.push_back(i);
-    if (i == uid)
-      routingTable[i] = std::make_tuple<int, int, double>(-1, -1, 0.0);
-    else {
-      auto it = std::find_if (
-        neighborCache.begin(), 
-        neighborCache.end(), 
-        [&](const CacheEntry& cacheEntry)->bool {
-          return std::get<MegaMerger::Index::NID>(cacheEntry) == i;
+  if (queueKind == QueueKind::RADIX_HEAP && !hasIntegerWeights(*graph))
+    throw omnetpp::cRuntimeError(
+      "Dijkstra: the radix heap requires non-negative integer weights"
+    );
+  if (routingMode != RoutingMode::LOCAL) {
+    // A forest holds n^2 entries, checked before any of them is allocated
+    if (networkSize > maxForestNodes)
+      throw omnetpp::cRuntimeError(
+        "Dijkstra: the routing tables of %d nodes take %.3g GiB, more than "
+        "maxForestNodes = %d allows; use the local routing mode",
+        networkSize, double(2 * sizeof(int) + sizeof(double))
+          * networkSize * networkSize / (1 << 30),
+        maxForestNodes
+      );
+    forest = AllPairsRouting::obtain(graph, queueKind, threads);
+    routingTable.assign(forest->row(uid));
+    return;
+  }
+  routingTable.resize(networkSize);
+  shortestPaths(
+    queueKind, *graph, uid, routingTable.prevData(),
+    routingTable.portData(), routingTable.distanceData()
+  );
+}
+
+int Dijkstra::verify(
+  const Oracle& oracle, const std::vector<MegaMerger*>& nodes
+) {
+  int mismatches = MegaMerger::verify(oracle, nodes);
+  int n = nodes.size();
+  int sources = std::min(n, int(par("verifySources").intValue()));
+  auto close = [](double a, double b) {
+    return a == b || std::abs(a - b) <= 1e-9 * std::max(1.0, std::abs(b));
+  };
+  int wrong = 0;
+  for (int j = 0; j < sources; j++) {
+    int s = (sources > 1) ? int(std::int64_t(j) * (n - 1) / (sources - 1)) : 0;
+    auto node = dynamic_cast<Dijkstra*>(nodes[s]);
+    if (!node)
+      continue;
+    const RoutingTable& table = node->routingTable;
+    if (table.size() != n) {
+      EV_ERROR << "Oracle: node " << s << " has a routing table of "
+               << table.size() << " entries\n";
+      wrong++;
+      continue;
+    }
+    auto distance = oracle.distances(s);
+    // The previous node of an entry must lie on a shortest path to it
+    auto onPath = [&](int i) {
+      int prev = table.prev(i);
+      return prev >= 0 && prev < n
+        && close(distance[prev] + oracle.weight(prev, i), distance[i]);
+    };
+    // The first hop towards each node, resolved by walking the prev chain
+    // and memoized. Zero-weight links give a previous node the distance of
+    // its successor, so the chain is walked instead of relying on distance
+    // order. -1 means a broken or cyclic chain
+    std::vector<int> firstHop(n, -1);
+    std::vector<char> state(n, 0); // 0 new, 1 on the walk, 2 resolved
+    std::vector<int> walk;
+    auto resolve = [&](int i) {
+      int hop = -1;
+      for (int v = i; ; v = table.prev(v)) {
+        if (v == s) {
+          hop = walk.empty() ? -1 : walk.back();
+          break;
         }
-      ); 
-      if (it != neighborCache.end()) {
-        get<0>(rtEntry) = uid; //prev uid
-        get<1>(rtEntry) = get<MegaMerger::Index::PORT>(neighborCache[i]);
-        get<2>(rtEntry) = get<MegaMerger::Index::WEIGHT>(neighborCache[i]);
-        routingTable[i] = std::move(rtEntry);
-        std::cout << "Neighbor " << i << " is in N(" <<getIndex() << ")\n";
-        std::cout << "Weight " << get<2>(routingTable[i]) << '\n';
+        if (state[v] == 2) {
+          hop = firstHop[v];
+          break;
+        }
+        if (state[v] == 1 || !onPath(v))
+          break;
+        state[v] = 1;
+        walk.push_back(v);
       }
-      else {
-        get<0>(rtEntry) = -1; //prev uid
-        get<1>(rtEntry) = -1; //port
-        get<2>(rtEntry) = std::numeric_limits<double>::infinity();
-        routingTable[i] = std::move(rtEntry);
+      for (int v : walk) {
+        firstHop[v] = hop;
+        state[v] = 2;
       }
-    }
-  }
-  while (!unvisited.empty()) {
-    int w = -1;
-    double weight = std::numeric_limits<double>::infinity();
-    std::vector<int>::iterator current;
-    for (auto it = unvisited.begin(); it != unvisited.end(); ++it) {
-      double minWeight = std::min(weight, get<2>(routingTable[*it]));
-      if (minWeight < weight) {
-        weight = minWeight;
-        w = *it;
-        current = it;
+      walk.clear();
+      return state[i] == 2 ? firstHop[i] : -1;
+    };
+    for (int i = 0; i < n; i++) {
+      bool right = close(table.distance(i), distance[i]);
+      if (right && i != s && !std::isinf(distance[i])) {
+        int port = table.port(i);
+        int hop = resolve(i);
+        right = onPath(i) && hop >= 0
+          && port >= 0 && port < node->neighborhoodSize
+          && node->getNeighbor(port)->getIndex() == hop;
       }
-    }
-    if (w >= 0) {
-      for (auto& v : (*graph)[w]) {
-        if (
-          std::find(unvisited.begin(), unvisited.end(), v.first) != 
-          unvisited.end()
-        ){
-          double distance = std::min(
-            get<2>(routingTable[v.first]),
-            get<2>(routingTable[w]) + v.second
-          );
-          if (get<2>(routingTable[v.first]) != distance) {
-            get<0>(rtEntry) = w; //prev uid
-            get<2>(rtEntry) = distance;
-            routingTable[v.first] = std::move(rtEntry);
-          }
-        }
+      if (!right) {
+        EV_ERROR << "Oracle: the entry of node " << i << " in the routing "
+                 << "table of node " << s << " is not a shortest path\n";
+        wrong++;
       }
     }
-    if (current != unvisited.end())
-      unvisited.erase(current);
   }
+  recordScalar("oracleRoutingTables", sources);
+  recordScalar("oracleRoutingMismatches", wrong);
+  return mismatches + wrong;
+}
+
+void Dijkstra::recordRoutingConvergence() {
+  routingTime = omnetpp::simTime();
+  maxNetworkScalar("routingTime", SIMTIME_DBL(routingTime));
+}
+
+void Dijkstra::startRouting() {
+  recordRoutingConvergence();
+  status = Status::ROUTING;
+  for (auto msg : pending)
+    forward(msg);
+  pending.clear();
+  if (source && packets != 0)
+    setTimer(par("sendInterval"));
+}
+
+void Dijkstra::forward(DataMsg* msg) {
+  int target = msg->getDestination();
+  if (target == uid) {
+    delivered++;
+    emit(latencySignal, omnetpp::simTime() - msg->getCreationTime());
+    emit(hopsSignal, long(msg->getHops()));
+    // The links are undirected, so the distance to the source is the length
+    // of the shortest path the packet could have taken
+    double shortest = routingTable.distance(msg->getSource());
+    if (shortest > 0)
+      emit(stretchSignal, msg->getPathWeight() / shortest);
+    delete msg;
+    return;
+  }
+  int port = (target >= 0 && target < routingTable.size())
+    ? routingTable.port(target) : -1;
+  if (port < 0) {
+    EV_WARN << "Node[" << uid << "] has no route to node " << target
+            << ", the packet is dropped\n";
+    dropped++;
+    delete msg;
+    return;
+  }
+  if (msg->getSource() != uid)
+    forwarded++;
+  msg->setHops(msg->getHops() + 1);
+  msg->setPathWeight(msg->getPathWeight() + getLinkWeight(port));
+  send(msg, out, port);
+}
+
+void Dijkstra::generate() {
+  if (packets == 0)
+    return;
+  int target = pickDestination();
+  if (target < 0)
+    return;
+  if (packets > 0)
+    packets--;
+  auto msg = new DataMsg;
+  msg->setSource(uid);
+  msg->setDestination(target);
+  msg->setByteLength(par("packetLength").intValue());
+  generated++;
+  forward(msg);
+  if (packets != 0)
+    setTimer(par("sendInterval"));
+}
+
+int Dijkstra::pickDestination() {
+  if (!destinations.empty()) {
+    int n = destinations.size();
+    // A destination that is also a source never picks itself
+    bool self = std::binary_search(destinations.begin(), destinations.end(), uid);
+    if (self && n == 1)
+      return -1;
+    int i = intuniform(0, n - 1 - (self ? 1 : 0));
+    if (self && destinations[i] >= uid)
+      i++;
+    return destinations[i];
+  }
+  if (networkSize < 2)
+    return -1;
+  int target = intuniform(0, networkSize - 2);
+  return (target >= uid) ? target + 1 : target;
 }
 
-void Dijkstra::printRoutingTable() {
-  std::cout << "Routing table of node " << getIndex() << '\n';
-  for (auto& entry : routingTable)
-    std::cout << "Destination: " << entry.first << '\n'
-              << "Previous node: " << std::get<0>(entry.second) << '\n'
-              << "Port: " << std::get<1>(entry.second) << '\n'
-              << "Distance: " << std::get<2>(entry.second) << '\n';
-  std::cout << std::endl;
+void Dijkstra::printRoutingTable(std::ostream& os) {
+  os << "Routing table of node " << getIndex() << '\n';
+  for (int i = 0; i < routingTable.size(); i++)
+    os << "Destination: " << i << '\n'
+       << "Previous node: " << routingTable.prev(i) << '\n'
+       << "Port: " << routingTable.port(i) << '\n'
+       << "Distance: " << routingTable.distance(i) << '\n';
+  os << std::endl;
 
 }
 
@@ -138,58 +361,95 @@ void Dijkstra::StartingConvergecast::operator()(Msg* msg) {
   }
 }
 
-void Dijkstra::ConvergecastingNeighborhood::operator()(Msg* msg) {
-  auto nMsg = dynamic_cast<NeighborhoodMsg*>(msg);
+void Dijkstra::ConvergecastingNeighborhood::operator()(NeighborhoodMsg* nMsg) {
   if (ap->leaderFlag && ap->status == Status::LEADER) {
     NeighborhoodEntry entry;
     ap->counter = 0;
     ap->networkSize = 1;
     ap->n = std::make_shared<std::list<NeighborhoodEntry>>();
-    for (auto& neighbor : ap->neighborCache) {
+    for (int i = 0; i < ap->neighborCache.size(); i++) {
       std::get<0>(entry) = ap->uid;
-      std::get<1>(entry) = std::get<MegaMerger::Index::NID>(neighbor);
-      std::get<2>(entry) = std::get<MegaMerger::Index::WEIGHT>(neighbor);
+      std::get<1>(entry) = ap->neighborCache.nid(i);
+      std::get<2>(entry) = ap->neighborCache.weight(i);
       ap->n->push_back(entry);
     }
     ap->leaderFlag = false;
   }
   ap->counter++;
   ap->networkSize += nMsg->getSubtreeSize();
-  ap->n->insert(ap->n->end(), nMsg->getN()->begin(), nMsg->getN()->end());
+  if (ap->routingMode == RoutingMode::LEADER) {
+    // Entries of a node are contiguous, so every run of equal uids is a node
+    auto& members = ap->subtrees[nMsg->getArrivalGate()->getIndex()];
+    members.clear();
+    for (auto& entry : *nMsg->getN())
+      if (members.empty() || members.back() != std::get<0>(entry))
+        members.push_back(std::get<0>(entry));
+    std::sort(members.begin(), members.end());
+  }
+  // The child no longer needs its list, so its entries are moved, not copied
+  ap->n->splice(ap->n->end(), *nMsg->getN());
+  nMsg->setN(nullptr);
   if (ap->counter == ap->children.size()) {
     if (ap->status == Status::LEADER) {
+      delete nMsg;
       ap->computeGraph();
-      ap->printGraph();
+      ap->dump([this](std::ostream& os) { ap->printGraph(os); });
       ap->computeRoutingTable();
-      ap->printRoutingTable();
+      ap->dump([this](std::ostream& os) { ap->printRoutingTable(os); });
       ap->sendGraph();
-      ap->status = Status::ROUTING;
+      ap->startRouting();
     }
-    else
+    else {
       ap->sendNeighborhood(nMsg);
+      ap->status = Status::PROCESSING;
+    }
   }
+  else
+    delete nMsg;
 }
 
-void Dijkstra::ComputingRT::operator()(Msg* msg) {
-  auto graphMsg = dynamic_cast<GraphMsg*>(msg);
-  ap->graph = graphMsg->getM();
-  ap->networkSize = ap->graph->size();
-  ap->computeRoutingTable();
+void Dijkstra::ComputingRT::operator()(GraphMsg* graphMsg) {
+  auto& rows = graphMsg->getRows();
+  if (rows) {
+    if (!std::binary_search(rows->sources.begin(), rows->sources.end(), ap->uid)
+        || !rows->forest->contains(ap->uid))
+      throw omnetpp::cRuntimeError(
+        "Dijkstra: node %d received the rows of another subtree", ap->uid
+      );
+    ap->forest = rows->forest;
+    ap->networkSize = ap->forest->size();
+    ap->routingTable.assign(ap->forest->row(ap->uid));
+  }
+  else {
+    ap->graph = graphMsg->getM();
+    ap->networkSize = ap->graph->size();
+    ap->computeRoutingTable();
+  }
   ap->sendGraph(graphMsg);
-  ap->status = Status::ROUTING;
+  ap->startRouting();
+}
+
+void Dijkstra::Routing::operator()(DataMsg* msg) {
+  ap->forward(msg);
+}
+
+void Dijkstra::Generating::operator()(Timeout*) {
+  // The timer belongs to BaseNode and is not deleted, generate() sets it
+  // again for the next packet
+  ap->generate();
 }
 
-void Dijkstra::Routing::operator()(Msg* msg) {
-  delete msg;
+void Dijkstra::Holding::operator()(DataMsg* msg) {
+  ap->pending.push_back(msg);
 }
 
-void Dijkstra::printGraph() {
-  std::cout << "network size: " << networkSize << '\n';
+void Dijkstra::printGraph(std::ostream& os) {
+  os << "network size: " << networkSize << '\n';
   for (int i = 0; i < networkSize; i++){
-    std::cout << "Node[" << i << "] = { ";
-    for (auto& item : (*graph)[i]) {
-      std::cout << '(' << item.first << ", " << item.second << ") ";
+    os << "Node[" << i << "] = { ";
+    for (int e = graph->begin(i); e < graph->end(i); e++) {
+      os << '(' << graph->target(e) << ", " << graph->weight(e) << ") ";
     }
-    std::cout << "}\n";
+    os << "}\n";
   }
 }
\ No newline at end of file
@@ -19,82 +19,202 @@
 #include "MegaMerger.h"
 #include "NeighborhoodMsg_m.h"
 #include "GraphMsg_m.h"
+#include "DataMsg_m.h"
+#include "ShortestPaths.h"
+#include "AllPairsRouting.h"
+#include "RoutingTable.h"
 
 #include <numeric>
 #include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+template <> struct MessageOf<EventKind::NEIGHBORHOOD> {
+  typedef NeighborhoodMsg type;
+};
+template <> struct MessageOf<EventKind::GRAPH> { typedef GraphMsg type; };
+template <> struct MessageOf<EventKind::DATA> { typedef DataMsg type; };
 
 class Dijkstra : public MegaMerger {
 public:
+  Dijkstra() {
+    if (population++ == 0)
+      destinations.clear();
+  }
+  ~Dijkstra();
   virtual void initialize() override;
-  typedef std::tuple<int, int, double> RTEntry; //prev. uid, port, distance
-  typedef std::unordered_map<int, RTEntry> RoutingTable;
+  virtual void finish() override;
+  /** @brief Returns the size of the fields of a routing message */
+  virtual long payloadSize(const omnetpp::cMessage*) const override;
+  typedef RoutingTable::Entry RTEntry; //prev. uid, port, distance
+  /** @brief The ways of computing routing tables */
+  enum RoutingMode {
+    LOCAL = 0, // Each node runs the single-source engine on its own
+    SHARED,    // Nodes share the forest of the graph they receive
+    LEADER     // The leader computes the forest and ships each subtree its rows
+  };
 protected:
+  QueueKind queueKind;
+  RoutingMode routingMode;
+  /** @brief The number of threads computing the forest */
+  int threads;
+  /** @brief The largest network whose forest may be computed */
+  int maxForestNodes;
+  /** @brief Where dumps go: "stdout", a file name, or empty for no dump */
+  std::string dumpTarget;
   int networkSize;
-  int counter;
+  unsigned counter;
   bool source;
   bool destination, leaderFlag = true;
   Neighborhood n;
   AdjacencyMatrix graph;
+  /** @brief The routing table, it views a row of forest if forest is set */
   RoutingTable routingTable;
+  /** @brief The forest holding the routing table in the shared and leader
+   *  modes */
+  std::shared_ptr<const AllPairsRouting> forest;
+  /** @brief The uids of the nodes in the subtree of each child, indexed by
+   *  port. Only the leader mode records them */
+  std::unordered_map<int, std::vector<int>> subtrees;
+  MessagePool<GraphMsg> graphPool;
+  /** @brief The time this node got its routing table */
+  omnetpp::simtime_t routingTime = -1;
+  /** @brief The number of packets this source has yet to send, -1 for no
+   *  limit */
+  int packets;
+  /** @brief The data packets this node generates, sinks, forwards and drops
+   *  for lack of a route */
+  long generated = 0, delivered = 0, forwarded = 0, dropped = 0;
+  /** @brief The data packets received before the routing table is ready */
+  std::vector<DataMsg*> pending;
+  /** @brief The sorted uids of the nodes whose destination parameter is
+   *  set, the sources draw the destination of each packet from them. The
+   *  nodes of a network register in initialize(), so the list is emptied
+   *  whenever the first node of a network is built. Parallel runs register
+   *  the nodes of the local partition only */
+  static std::vector<int> destinations;
+  /** @brief The number of live Dijkstra nodes */
+  static int population;
+  static omnetpp::simsignal_t latencySignal;
+  static omnetpp::simsignal_t hopsSignal;
+  static omnetpp::simsignal_t stretchSignal;
 protected:
+  /** @brief Copies graph messages from the graph pool */
+  virtual omnetpp::cMessage* replicate(omnetpp::cMessage*) override;
+  /** @brief Gives graph messages back to the graph pool */
+  virtual void recycle(omnetpp::cMessage*) override;
   virtual void sendNeighborhood(NeighborhoodMsg* msg = nullptr);
   virtual void sendGraph(GraphMsg* msg = nullptr);
   virtual void computeGraph();
   virtual void computeRoutingTable();
-  virtual void printRoutingTable();
-  virtual void printGraph();
+  /** @brief Checks the spanning tree and the routing tables of some nodes,
+   *  spread over the uids, against the oracle. A table is right if its
+   *  distances are the shortest ones, every predecessor lies on a shortest
+   *  path and every port leads to the first hop of one */
+  virtual int verify(const Oracle&, const std::vector<MegaMerger*>&) override;
+  /** @brief Notes the time this node starts routing */
+  virtual void recordRoutingConvergence();
+  /** @brief Enters the routing status: forwards the data packets held so
+   *  far and, if this node is a source, starts its traffic */
+  virtual void startRouting();
+  /** @brief Sinks a data packet addressed to this node, otherwise sends it
+   *  through the port the routing table gives for its destination */
+  virtual void forward(DataMsg*);
+  /** @brief Sends a data packet to a random destination and sets the timer
+   *  of the next one */
+  virtual void generate();
+  /** @brief Returns a random destination other than this node, -1 if there
+   *  is none. It is drawn from the destination nodes or, if no node is a
+   *  destination, from every node */
+  virtual int pickDestination();
+  virtual void printRoutingTable(std::ostream& os);
+  virtual void printGraph(std::ostream& os);
+  /** @brief Calls print with the stream the dump parameter selects. Files are
+   *  opened in append mode on every dump, so nodes can share a file */
+  template <typename F> void dump(F print);
 protected:
   class StartingConvergecast;
   class ConvergecastingNeighborhood;
   class ComputingRT;
   class Routing;
+  class Generating;
+  class Holding;
+  /** @brief The rules of Mega-Merger plus the ones of the routing phase. The
+   *  termination of Mega-Merger starts the neighborhood convergecast. Data
+   *  packets may reach a node before its routing table does, it holds them
+   *  until it starts routing */
+  typedef ExtendedSpec<
+    MegaMerger::Protocol,
+    Rule<Status::CONNECTING, EventKind::TERMINATION, StartingConvergecast>,
+    Rule<Status::FOLLOWER, EventKind::NEIGHBORHOOD, ConvergecastingNeighborhood>,
+    Rule<Status::LEADER, EventKind::NEIGHBORHOOD, ConvergecastingNeighborhood>,
+    Rule<Status::PROCESSING, EventKind::GRAPH, ComputingRT>,
+    Rule<Status::ROUTING, EventKind::DATA, Routing>,
+    Rule<Status::ROUTING, EventKind::TIMEOUT, Generating>,
+    Rule<Status::CONNECTING, EventKind::DATA, Holding>,
+    Rule<Status::FOLLOWER, EventKind::DATA, Holding>,
+    Rule<Status::PROCESSING, EventKind::DATA, Holding>
+  > Protocol;
 };
 
-class Dijkstra::StartingConvergecast : public BaseAction {
+template <typename F>
+void Dijkstra::dump(F print) {
+  if (dumpTarget.empty())
+    return;
+  if (dumpTarget == "stdout") {
+    print(std::cout);
+    return;
+  }
+  std::ofstream file(dumpTarget, std::ios::app);
+  if (!file)
+    throw omnetpp::cRuntimeError(
+      "Dijkstra: cannot open dump file \"%s\"", dumpTarget.c_str()
+    );
+  print(file);
+}
+
+class Dijkstra::StartingConvergecast : public Action<Dijkstra> {
 private:
-  Dijkstra* ap;
   MegaMerger::Solving solving;
 public:
   StartingConvergecast(Dijkstra* ptr)
-    : BaseAction("StartingConvergecast")
-    , ap(ptr)
+    : Action(ptr)
     , solving(ap)
 { }
   void operator()(Msg*);
 };
 
-class Dijkstra::ConvergecastingNeighborhood : public BaseAction {
-private:
-  Dijkstra* ap;
+class Dijkstra::ConvergecastingNeighborhood : public Action<Dijkstra> {
 public:
-  ConvergecastingNeighborhood(Dijkstra* ptr)
-    : BaseAction("ConvergecastingNeighborhood")
-    , ap(ptr)
-{ }
-  void operator()(Msg*);
+  ConvergecastingNeighborhood(Dijkstra* ptr) : Action(ptr) { }
+  void operator()(NeighborhoodMsg*);
 };
 
 
-class Dijkstra::ComputingRT : public BaseAction {
-private:
-  Dijkstra* ap;
+class Dijkstra::ComputingRT : public Action<Dijkstra> {
 public:
-  ComputingRT(Dijkstra* ptr)
-    : BaseAction("ComputingRT")
-    , ap(ptr)
-{ }
-  void operator()(Msg*);
+  ComputingRT(Dijkstra* ptr) : Action(ptr) { }
+  void operator()(GraphMsg*);
 };
 
-class Dijkstra::Routing : public BaseAction {
-private:
-  Dijkstra* ap;
+class Dijkstra::Routing : public Action<Dijkstra> {
 public:
-  Routing(Dijkstra* ptr)
-    : BaseAction("Routing")
-    , ap(ptr)
-{ }
-  void operator()(Msg*);
+  Routing(Dijkstra* ptr) : Action(ptr) { }
+  void operator()(DataMsg*);
+};
+
+class Dijkstra::Generating : public Action<Dijkstra> {
+public:
+  Generating(Dijkstra* ptr) : Action(ptr) { }
+  void operator()(Timeout*);
+};
+
+class Dijkstra::Holding : public Action<Dijkstra> {
+public:
+  Holding(Dijkstra* ptr) : Action(ptr) { }
+  void operator()(DataMsg*);
 };
 
 
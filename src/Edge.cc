@@ -1,12 +1,20 @@
 #include "Edge.h"
 
+#include <cstring>
+
+#include "BaseNode.h"
+
 Define_Channel(Edge);
 
 void Edge::initialize() {
   cDelayChannel::initialize();
+  weight = par("weight");
+  displayWeight();
+}
+
+void Edge::displayWeight() {
   if (par("showWeight")) {
     int precision = par("precision");
-    weight = par("weight");
     auto weight_str = std::to_string(weight).substr(0, std::to_string(weight).find(".") + precision + 1);
     getDisplayString().setTagArg("t", 0, weight_str.c_str());
     getDisplayString().setTagArg("t", 1, "l");
@@ -14,6 +22,18 @@ void Edge::initialize() {
   }
 }
 
+void Edge::handleParameterChange(const char* name) {
+  cDelayChannel::handleParameterChange(name);
+  if (name && std::strcmp(name, "weight") != 0)
+    return;
+  weight = par("weight");
+  displayWeight();
+  omnetpp::cGate* source = getSourceGate();
+  auto node = source ? dynamic_cast<BaseNode*>(source->getOwnerModule()) : nullptr;
+  if (node)
+    node->handleLinkWeightChange(source->getIndex(), weight);
+}
+
 double Edge::getWeight() {
   return weight;
 }
@@ -23,9 +23,14 @@ class Edge : public omnetpp::cDelayChannel {
 protected:
   double weight;
   bool showWeight;
+  /** @brief Labels the edge with its weight if showWeight is set */
+  void displayWeight();
 public:
   Edge() : omnetpp::cDelayChannel("name"), weight(1.0), showWeight(0) { }
   virtual void initialize () override;
+  /** @brief Keeps the weight, its label and the weight cache of the node
+   *  owning the source gate up to date when the weight changes at runtime */
+  virtual void handleParameterChange(const char* name) override;
   virtual double getWeight();
 };
 
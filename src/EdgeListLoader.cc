@@ -0,0 +1,194 @@
+#include "EdgeListLoader.h"
+
+#include <omnetpp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/** @brief The greatest node ID plus one */
+static const long limit = std::numeric_limits<int>::max();
+
+EdgeListLoader::EdgeListLoader(
+  const std::string& path, Format f, bool halve
+)
+  : data(nullptr)
+  , length(0)
+  , descriptor(-1)
+  , format(f)
+  , halve(halve)
+  , links(0)
+  , loops(0)
+{
+#if !defined(_WIN32)
+  descriptor = open(path.c_str(), O_RDONLY);
+  if (descriptor < 0)
+    throw omnetpp::cRuntimeError(
+      "EdgeListLoader: cannot open \"%s\"", path.c_str()
+    );
+  struct stat info;
+  if (fstat(descriptor, &info) < 0) {
+    close(descriptor);
+    throw omnetpp::cRuntimeError(
+      "EdgeListLoader: cannot stat \"%s\"", path.c_str()
+    );
+  }
+  length = info.st_size;
+  if (length > 0) {
+    void* map = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (map == MAP_FAILED) {
+      close(descriptor);
+      throw omnetpp::cRuntimeError(
+        "EdgeListLoader: cannot map \"%s\"", path.c_str()
+      );
+    }
+    madvise(map, length, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(map);
+  }
+#else
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+    throw omnetpp::cRuntimeError(
+      "EdgeListLoader: cannot open \"%s\"", path.c_str()
+    );
+  buffer.assign(
+    std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()
+  );
+  data = buffer.data();
+  length = buffer.size();
+#endif
+  try {
+    bool magic = length >= 4 && std::memcmp(data, "DSEL", 4) == 0;
+    if (format == Format::AUTO)
+      format = magic ? Format::BINARY : Format::TEXT;
+    else if (format == Format::BINARY && !magic)
+      throw omnetpp::cRuntimeError(
+        "EdgeListLoader: \"%s\" is not a binary edge list", path.c_str()
+      );
+    if (format == Format::BINARY && (length - 4) % record != 0)
+      throw omnetpp::cRuntimeError(
+        "EdgeListLoader: \"%s\" is truncated, %ld bytes follow the last "
+        "record", path.c_str(), long((length - 4) % record)
+      );
+    // Degree pre-pass, so the gates of every node are allocated once. The
+    // links are also collected as (min, max) keys to find duplicates
+    std::vector<std::uint64_t> keys;
+    scan([&](long u, long v, double w) {
+      if (u < 0 || v < 0 || u >= limit || v >= limit)
+        throw omnetpp::cRuntimeError(
+          "EdgeListLoader: invalid link (%ld, %ld)", u, v
+        );
+      if (!(w >= 0) || std::isinf(w))
+        throw omnetpp::cRuntimeError(
+          "EdgeListLoader: invalid weight %g of link (%ld, %ld)", w, u, v
+        );
+      if (u == v) {
+        loops++;
+        return;
+      }
+      if (halve && u > v)
+        return;
+      long n = std::max(u, v) + 1;
+      if (n > long(degrees.size()))
+        degrees.resize(n, 0);
+      degrees[u]++;
+      degrees[v]++;
+      links++;
+      keys.push_back(std::uint64_t(std::min(u, v)) << 32 | std::max(u, v));
+    });
+    std::sort(keys.begin(), keys.end());
+    auto duplicate = std::adjacent_find(keys.begin(), keys.end());
+    if (duplicate != keys.end())
+      throw omnetpp::cRuntimeError(
+        "EdgeListLoader: \"%s\" lists the link (%ld, %ld) twice",
+        path.c_str(), long(*duplicate >> 32), long(*duplicate & 0xffffffff)
+      );
+    // An ID in no link would be a node cut off from the rest of the network
+    auto isolated = std::find(degrees.begin(), degrees.end(), 0);
+    if (isolated != degrees.end())
+      throw omnetpp::cRuntimeError(
+        "EdgeListLoader: %ld node IDs of \"%s\" are in no link, the first "
+        "is %ld", long(std::count(isolated, degrees.end(), 0)), path.c_str(),
+        long(isolated - degrees.begin())
+      );
+  }
+  catch (...) {
+    unmap();
+    throw;
+  }
+}
+
+EdgeListLoader::~EdgeListLoader() {
+  unmap();
+}
+
+void EdgeListLoader::unmap() {
+#if !defined(_WIN32)
+  if (data)
+    munmap(const_cast<char*>(data), length);
+  if (descriptor >= 0)
+    close(descriptor);
+  descriptor = -1;
+#endif
+  data = nullptr;
+  length = 0;
+}
+
+bool EdgeListLoader::parseLine(
+  const char*& p, long& u, long& v, double& w
+) const {
+  const char* end = data + length;
+  auto blank = [&] {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r'))
+      p++;
+  };
+  auto digit = [&] { return p < end && *p >= '0' && *p <= '9'; };
+  auto integer = [&](long& x) {
+    blank();
+    if (!digit())
+      return false;
+    for (x = 0; digit(); p++)
+      x = std::min(10 * x + (*p - '0'), limit);
+    return true;
+  };
+  if (p >= end)
+    return false;
+  u = -1;
+  w = 1.0;
+  blank();
+  if (p < end && *p != '#' && *p != '%' && *p != '\n') {
+    if (!integer(u) || !integer(v))
+      throw omnetpp::cRuntimeError(
+        "EdgeListLoader: malformed line at byte %ld", long(p - data)
+      );
+    blank();
+    if (p < end && *p != '\n') {
+      // A weight is short, so it is copied to a terminated buffer for strtod
+      char token[64];
+      std::size_t k = 0;
+      while (p < end && k + 1 < sizeof token && !std::strchr(" \t\r\n,", *p))
+        token[k++] = *p++;
+      token[k] = '\0';
+      char* last;
+      w = std::strtod(token, &last);
+      if (last == token || *last != '\0'
+          || (p < end && !std::strchr(" \t\r\n,", *p)))
+        throw omnetpp::cRuntimeError(
+          "EdgeListLoader: malformed weight at byte %ld", long(p - data)
+        );
+    }
+  }
+  const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+  p = eol ? eol + 1 : end;
+  return true;
+}
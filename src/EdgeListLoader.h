@@ -0,0 +1,131 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#if !defined(EDGE_LIST_LOADER_H)
+#define EDGE_LIST_LOADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/** @brief Reads a topology from an edge-list file without copying it: the
+ *  file is memory-mapped and parsed in place, once to count the degree of
+ *  every node and once more to hand each link to the caller. Two formats
+ *  are supported:
+ *
+ *  - text: one link per line, "src dst [weight]" separated by blanks or
+ *    commas, the weight defaults to 1; lines starting with '#' or '%' are
+ *    comments.
+ *  - binary: the magic "DSEL" followed by packed little-endian records
+ *    (int32 src, int32 dst, float64 weight) of 16 bytes.
+ *
+ *  Nodes are numbered 0..n-1, n being the greatest ID plus one, and every
+ *  ID must appear in some link. Self-loops are skipped. Weights must be
+ *  finite and non-negative. A link must be listed once, in either
+ *  direction, or twice with halve, one per direction: duplicates are
+ *  rejected rather than merged, since the weights of two copies may differ
+ *  and neither one is the right one.
+ *  @author A.G. Medrano-Chavez
+ */
+class EdgeListLoader {
+public:
+  /** @brief The formats of edge-list files */
+  enum Format {
+    AUTO = 0, // Binary if the file starts with the magic, text otherwise
+    TEXT,
+    BINARY
+  };
+private:
+  /** @brief The size of a binary record */
+  static constexpr std::size_t record =
+    2 * sizeof(std::int32_t) + sizeof(double);
+  const char* data;
+  std::size_t length;
+  /** @brief The descriptor of the mapped file, -1 if it is not mapped */
+  int descriptor;
+  /** @brief The file contents when it cannot be mapped */
+  std::vector<char> buffer;
+  Format format;
+  /** @brief Keeps one direction of each link only, for files listing every
+   *  link twice */
+  bool halve;
+  std::vector<int> degrees;
+  long links;
+  long loops;
+  /** @brief Unmaps the file */
+  void unmap();
+  /** @brief Parses the next text line, returns false at the end of data */
+  bool parseLine(const char*& p, long& u, long& v, double& w) const;
+  /** @brief Parses the whole file handing each link to f */
+  template <typename F>
+  void scan(F f) const;
+public:
+  /** @brief Maps a file and counts the degrees of its nodes
+   *  @param path The file name
+   *  @param format The format of the file
+   *  @param halve Whether the file lists every link in both directions
+   */
+  EdgeListLoader(const std::string& path, Format format, bool halve);
+  EdgeListLoader(const EdgeListLoader&) = delete;
+  EdgeListLoader& operator=(const EdgeListLoader&) = delete;
+  /** @brief Unmaps the file */
+  ~EdgeListLoader();
+  /** @brief Returns the number of nodes */
+  int size() const { return degrees.size(); }
+  /** @brief Returns the number of links */
+  long getLinks() const { return links; }
+  /** @brief Returns the number of self-loops skipped */
+  long getLoops() const { return loops; }
+  /** @brief Returns the degree of each node */
+  const std::vector<int>& getDegrees() const { return degrees; }
+  /** @brief Hands every link to f(src, dst, weight) in file order */
+  template <typename F>
+  void forEach(F f) const;
+};
+
+template <typename F>
+void EdgeListLoader::scan(F f) const {
+  if (format == Format::BINARY) {
+    const char* p = data + 4;
+    for (const char* end = data + length; p + record <= end; p += record) {
+      std::int32_t u, v;
+      double w;
+      std::memcpy(&u, p, sizeof u);
+      std::memcpy(&v, p + sizeof u, sizeof v);
+      std::memcpy(&w, p + 2 * sizeof u, sizeof w);
+      f(u, v, w);
+    }
+  }
+  else {
+    const char* p = data;
+    long u, v;
+    double w;
+    while (parseLine(p, u, v, w))
+      if (u >= 0)
+        f(u, v, w);
+  }
+}
+
+template <typename F>
+void EdgeListLoader::forEach(F f) const {
+  scan([&](long u, long v, double w) {
+    if (u != v && !(halve && u > v))
+      f(int(u), int(v), w);
+  });
+}
+
+#endif // EDGE_LIST_LOADER_H
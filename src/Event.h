@@ -56,7 +56,18 @@ enum EventKind {
   /** @brief The reception of adjacency matrix. */
   GRAPH,
   /** @brief The reception of a data packet */
-  DATA
+  DATA,
+  /** @brief The number of kinds of events, it must be the last one */
+  EVENT_KINDS
 };
 
+/** @brief Returns the name of an event kind, e.g., "REQ" */
+inline const char* eventKindName(int kind) {
+  static const char* const names[EVENT_KINDS] = {
+    "IMPULSE", "TIMEOUT", "FWD", "REQ", "REPLY", "QUERY", "YES", "NO",
+    "CHECK", "TERMINATION", "HELLO", "MIN", "NEIGHBORHOOD", "GRAPH", "DATA"
+  };
+  return (kind >= 0 && kind < EVENT_KINDS) ? names[kind] : "UNDEFINED";
+}
+
 #endif
\ No newline at end of file
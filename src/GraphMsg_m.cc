@@ -206,18 +206,21 @@ GraphMsg& GraphMsg::operator=(const GraphMsg& other)
 void GraphMsg::copy(const GraphMsg& other)
 {
     this->m = other.m;
+    this->rows = other.rows;
 }
 
 void GraphMsg::parsimPack(omnetpp::cCommBuffer *b) const
 {
     ::omnetpp::cMessage::parsimPack(b);
     doParsimPacking(b,this->m);
+    doParsimPacking(b,this->rows);
 }
 
 void GraphMsg::parsimUnpack(omnetpp::cCommBuffer *b)
 {
     ::omnetpp::cMessage::parsimUnpack(b);
     doParsimUnpacking(b,this->m);
+    doParsimUnpacking(b,this->rows);
 }
 
 AdjacencyMatrix& GraphMsg::getM()
@@ -230,6 +233,16 @@ void GraphMsg::setM(const AdjacencyMatrix& m)
     this->m = m;
 }
 
+RoutingRows& GraphMsg::getRows()
+{
+    return this->rows;
+}
+
+void GraphMsg::setRows(const RoutingRows& rows)
+{
+    this->rows = rows;
+}
+
 class GraphMsgDescriptor : public omnetpp::cClassDescriptor
 {
   private:
@@ -295,7 +308,7 @@ const char *GraphMsgDescriptor::getProperty(const char *propertyname) const
 int GraphMsgDescriptor::getFieldCount() const
 {
     omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
-    return basedesc ? 1+basedesc->getFieldCount() : 1;
+    return basedesc ? 2+basedesc->getFieldCount() : 2;
 }
 
 unsigned int GraphMsgDescriptor::getFieldTypeFlags(int field) const
@@ -308,8 +321,9 @@ unsigned int GraphMsgDescriptor::getFieldTypeFlags(int field) const
     }
     static unsigned int fieldTypeFlags[] = {
         FD_ISCOMPOUND,
+        FD_ISCOMPOUND,
     };
-    return (field>=0 && field<1) ? fieldTypeFlags[field] : 0;
+    return (field>=0 && field<2) ? fieldTypeFlags[field] : 0;
 }
 
 const char *GraphMsgDescriptor::getFieldName(int field) const
@@ -322,8 +336,9 @@ const char *GraphMsgDescriptor::getFieldName(int field) const
     }
     static const char *fieldNames[] = {
         "m",
+        "rows",
     };
-    return (field>=0 && field<1) ? fieldNames[field] : nullptr;
+    return (field>=0 && field<2) ? fieldNames[field] : nullptr;
 }
 
 int GraphMsgDescriptor::findField(const char *fieldName) const
@@ -331,6 +346,7 @@ int GraphMsgDescriptor::findField(const char *fieldName) const
     omnetpp::cClassDescriptor *basedesc = getBaseClassDescriptor();
     int base = basedesc ? basedesc->getFieldCount() : 0;
     if (fieldName[0]=='m' && strcmp(fieldName, "m")==0) return base+0;
+    if (fieldName[0]=='r' && strcmp(fieldName, "rows")==0) return base+1;
     return basedesc ? basedesc->findField(fieldName) : -1;
 }
 
@@ -344,8 +360,9 @@ const char *GraphMsgDescriptor::getFieldTypeString(int field) const
     }
     static const char *fieldTypeStrings[] = {
         "AdjacencyMatrix",
+        "RoutingRows",
     };
-    return (field>=0 && field<1) ? fieldTypeStrings[field] : nullptr;
+    return (field>=0 && field<2) ? fieldTypeStrings[field] : nullptr;
 }
 
 const char **GraphMsgDescriptor::getFieldPropertyNames(int field) const
@@ -413,6 +430,7 @@ std::string GraphMsgDescriptor::getFieldValueAsString(void *object, int field, i
     GraphMsg *pp = (GraphMsg *)object; (void)pp;
     switch (field) {
         case 0: {std::stringstream out; out << pp->getM(); return out.str();}
+        case 1: {std::stringstream out; out << pp->getRows(); return out.str();}
         default: return "";
     }
 }
@@ -441,6 +459,7 @@ const char *GraphMsgDescriptor::getFieldStructName(int field) const
     }
     switch (field) {
         case 0: return omnetpp::opp_typename(typeid(AdjacencyMatrix));
+        case 1: return omnetpp::opp_typename(typeid(RoutingRows));
         default: return nullptr;
     };
 }
@@ -456,6 +475,7 @@ void *GraphMsgDescriptor::getFieldStructValuePointer(void *object, int field, in
     GraphMsg *pp = (GraphMsg *)object; (void)pp;
     switch (field) {
         case 0: return (void *)(&pp->getM()); break;
+        case 1: return (void *)(&pp->getRows()); break;
         default: return nullptr;
     }
 }
@@ -19,21 +19,24 @@
 
 
 // cplusplus {{
-  #include <utility>
   #include <memory>
   #include "Event.h"
-  typedef std::list<std::pair<int, double>> MatrixEntry;
-  typedef std::shared_ptr<std::vector<MatrixEntry>> AdjacencyMatrix;
+  #include "CsrGraph.h"
+  #include "AllPairsRouting.h"
+  #include "ParsimPacking.h"
+  typedef std::shared_ptr<const CsrGraph> AdjacencyMatrix;
+  typedef std::shared_ptr<const RoutingBundle> RoutingRows;
 // }}
 
 /**
- * Class generated from <tt>GraphMsg.msg:12</tt> by nedtool.
+ * Class generated from <tt>GraphMsg.msg:15</tt> by nedtool.
  * <pre>
  * message GraphMsg
  * {
  *     name = "graph";
  *     kind = EventKind::GRAPH;
  *     AdjacencyMatrix m;
+ *     RoutingRows rows;
  * }
  * </pre>
  */
@@ -41,6 +44,7 @@ class GraphMsg : public ::omnetpp::cMessage
 {
   protected:
     AdjacencyMatrix m;
+    RoutingRows rows;
 
   private:
     void copy(const GraphMsg& other);
@@ -62,6 +66,9 @@ class GraphMsg : public ::omnetpp::cMessage
     virtual AdjacencyMatrix& getM();
     virtual const AdjacencyMatrix& getM() const {return const_cast<GraphMsg*>(this)->getM();}
     virtual void setM(const AdjacencyMatrix& m);
+    virtual RoutingRows& getRows();
+    virtual const RoutingRows& getRows() const {return const_cast<GraphMsg*>(this)->getRows();}
+    virtual void setRows(const RoutingRows& rows);
 };
 
 inline void doParsimPacking(omnetpp::cCommBuffer *b, const GraphMsg& obj) {obj.parsimPack(b);}
@@ -3,7 +3,8 @@
 Define_Module(MegaMerger);
 
 MegaMerger::MegaMerger()
-  : expectedContactPointUid(-1)
+  : neighborCache(LinkKind::UNKNOWN)
+  , expectedContactPointUid(-1)
   , isConvergecastFinished(false)
   , cid(-1)
   , parent(-1)
@@ -11,9 +12,7 @@ MegaMerger::MegaMerger()
 { }
 
 MegaMerger::~MegaMerger() {
-  for (auto& ptr : queryCache)
-    delete ptr;
-  for (auto& ptr : reqCache)
+  for (auto& ptr : minCache)
     delete ptr;
 }
 
@@ -21,58 +20,134 @@ void MegaMerger::initialize() {
   if (par("initiator").boolValue())
     spontaneously();
   initializeNeighborhood();
-  
-  for (int i = 0; i < neighborhoodSize; i++) {
-    CacheEntry entry(
-      std::numeric_limits<double>::infinity(),
-      std::numeric_limits<int>::max(),
-      std::numeric_limits<int>::max(),
-      -1,
-      -1,
-      -1,
-      LinkKind::UNKNOWN
-    );
-    neighborCache.push_back(std::move(entry));
-  }
+  int capacity = par("poolCapacity").intValue();
+  helloPool.setCapacity(capacity);
+  queryPool.setCapacity(capacity);
+  minPool.setCapacity(capacity);
+  reqPool.setCapacity(capacity);
+  checkPool.setCapacity(capacity);
+  signalPool.setCapacity(capacity);
+  neighborCache.assign(neighborhoodSize, LinkKind::UNKNOWN);
   unknownLinkCnt = neighborhoodSize;
-  addRule(Status::IDLE, EventKind::IMPULSE, New_Action(WakingUp));
-  addRule(Status::IDLE, EventKind::HELLO, New_Action(BroadcastingHello));
-  addRule(Status::CONNECTING, EventKind::REQ, New_Action(ClusterMerger));
-  addRule(Status::CONNECTING, EventKind::FWD, New_Action(ForwardingRequest));
-  addRule(Status::CONNECTING, EventKind::QUERY, New_Action(ReplyingQuery));
-  addRule(Status::CONNECTING, EventKind::CHECK, New_Action(Expanding));
-  addRule(Status::CONNECTING, EventKind::TERMINATION, New_Action(Solving));
-  addRule(Status::UPDATING, EventKind::HELLO, New_Action(UpdatingCache));
-  addRule(Status::UPDATING, EventKind::QUERY, New_Action(ReplyingQuery));
-  addRule(Status::UPDATING, EventKind::YES, New_Action(ProcessingYes));
-  addRule(Status::UPDATING, EventKind::NO, New_Action(ProcessingNo));
-  addRule(Status::UPDATING, EventKind::REQ, New_Action(TryingAbsorption));
-  addRule(Status::UPDATING, EventKind::MIN, New_Action(CachingMinimum));
-  addRule(Status::PROCESSING, EventKind::MIN, New_Action(ComputingMinimum));
-  addRule(Status::PROCESSING, EventKind::QUERY, New_Action(ReplyingQuery));
-  addRule(Status::PROCESSING, EventKind::REQ, New_Action(TryingAbsorption));
+  static const RuleTable rules(&Protocol::addRules);
+  setRules(&rules);
   status = Status::IDLE;
+  initializeMetrics();
   WATCH(unknownLinkCnt);
   WATCH(outgoingPortIndex);
   WATCH(expectedContactPointUid);
 }
 
+void MegaMerger::finish() {
+  if (getIndex() == 0 && par("verify").boolValue())
+    runOracle();
+  addNetworkScalar("merges", merges);
+  addNetworkScalar("absorptions", absorptions);
+  maxNetworkScalar("level", level);
+  recordScalar("merges", merges);
+  recordScalar("absorptions", absorptions);
+  recordScalar("level", level);
+  if (mstTime >= SIMTIME_ZERO)
+    recordScalar("mstTime", mstTime, "s");
+  BaseNode::finish();
+  recordScalar("helloPoolHits", helloPool.getHits());
+  recordScalar("helloPoolMisses", helloPool.getMisses());
+  recordScalar("queryPoolHits", queryPool.getHits());
+  recordScalar("queryPoolMisses", queryPool.getMisses());
+  recordScalar("minPoolHits", minPool.getHits());
+  recordScalar("minPoolMisses", minPool.getMisses());
+  recordScalar("reqPoolHits", reqPool.getHits());
+  recordScalar("reqPoolMisses", reqPool.getMisses());
+  recordScalar("checkPoolHits", checkPool.getHits());
+  recordScalar("checkPoolMisses", checkPool.getMisses());
+  recordScalar("signalPoolHits", signalPool.getHits());
+  recordScalar("signalPoolMisses", signalPool.getMisses());
+}
+
+long MegaMerger::payloadSize(const omnetpp::cMessage* msg) const {
+  switch (msg->getKind()) {
+  case EventKind::HELLO:
+    return sizeof(int);
+  case EventKind::FWD:
+  case EventKind::REQ:
+    return 3 * sizeof(int);
+  case EventKind::QUERY:
+    return 2 * sizeof(int);
+  case EventKind::CHECK:
+    return sizeof(bool) + 2 * sizeof(int);
+  case EventKind::MIN:
+    return 3 * sizeof(int) + sizeof(double);
+  default:
+    return BaseNode::payloadSize(msg);
+  }
+}
+
+omnetpp::cMessage* MegaMerger::replicate(omnetpp::cMessage* msg) {
+  switch (msg->getKind()) {
+  case EventKind::HELLO:
+    return helloPool.copy(*static_cast<HelloMsg*>(msg));
+  case EventKind::CHECK:
+    return checkPool.copy(*static_cast<CheckMsg*>(msg));
+  case EventKind::QUERY:
+    return queryPool.copy(*static_cast<QueryMsg*>(msg));
+  case EventKind::MIN:
+    return minPool.copy(*static_cast<MinMsg*>(msg));
+  case EventKind::REQ:
+  case EventKind::FWD:
+    return reqPool.copy(*static_cast<ReqMsg*>(msg));
+  case EventKind::YES:
+  case EventKind::NO:
+  case EventKind::TERMINATION:
+    return signalPool.copy(*msg);
+  default:
+    return BaseNode::replicate(msg);
+  }
+}
+
+void MegaMerger::recycle(omnetpp::cMessage* msg) {
+  switch (msg->getKind()) {
+  case EventKind::HELLO:
+    helloPool.release(static_cast<HelloMsg*>(msg));
+    break;
+  case EventKind::CHECK:
+    checkPool.release(static_cast<CheckMsg*>(msg));
+    break;
+  case EventKind::QUERY:
+    queryPool.release(static_cast<QueryMsg*>(msg));
+    break;
+  case EventKind::MIN:
+    minPool.release(static_cast<MinMsg*>(msg));
+    break;
+  case EventKind::REQ:
+  case EventKind::FWD:
+    reqPool.release(static_cast<ReqMsg*>(msg));
+    break;
+  case EventKind::YES:
+  case EventKind::NO:
+  case EventKind::TERMINATION:
+    signalPool.release(msg);
+    break;
+  default:
+    BaseNode::recycle(msg);
+  }
+}
+
 void MegaMerger::refreshDisplay() const {
   std::string info(status.str());
   info += '\n' + std::to_string(cid) + ' ' 
                + std::to_string(level) + '\n';
   displayInfo(info.c_str());
   for (int i = 0; i < neighborhoodSize; i++) {
-    if (std::get<Index::KIND>(neighborCache[i]) == LinkKind::BRANCH) {
+    if (neighborCache.kind(i) == LinkKind::BRANCH) {
       changeEdgeColor(i, "teal");
       changeEdgeWidth(i, 4);
     }
-    else if (std::get<Index::KIND>(neighborCache[i]) == LinkKind::INTERNAL) {
+    else if (neighborCache.kind(i) == LinkKind::INTERNAL) {
       changeEdgeColor(i, "teal");
       changeEdgeWidth(i, 4);
       setEdgeDashed(i);
     }
-    else if (std::get<Index::KIND>(neighborCache[i]) == LinkKind::UNKNOWN) 
+    else if (neighborCache.kind(i) == LinkKind::UNKNOWN) 
       changeEdgeColor(i, "black");
     else //Outgoing link
       changeEdgeColor(i, "orange");
@@ -80,13 +155,15 @@ void MegaMerger::refreshDisplay() const {
 }
 
 void MegaMerger::sendMin() {
-  auto min = new MinMsg;
+  auto min = minPool.acquire();
   if (outgoingPortIndex >= 0) {
+    min->setUid(contactPointId);
     min->setWeight(std::get<Index::WEIGHT>(outgoingLink));
     min->setMinUid(std::get<Index::MIN_ID>(outgoingLink));
     min->setMaxUid(std::get<Index::MAX_ID>(outgoingLink));
   }
   else {
+    min->setUid(uid);
     min->setWeight(std::numeric_limits<double>::infinity());
     min->setMinUid(std::numeric_limits<int>::max());
     min->setMaxUid(std::numeric_limits<int>::max());
@@ -96,7 +173,7 @@ void MegaMerger::sendMin() {
 
 void MegaMerger::forwardRequest(ReqMsg* req) {
   if (!req) {
-    req = new ReqMsg;
+    req = reqPool.acquire();
     req->setCid(cid);
     req->setLevel(level);
     req->setContactPointId(contactPointId);
@@ -109,28 +186,30 @@ void MegaMerger::forwardRequest(ReqMsg* req) {
 }
 
 void MegaMerger::sendQuery() {
-  auto query = new QueryMsg;
+  auto query = queryPool.acquire();
   query->setCid(cid);
   query->setLevel(level);
   send(query, out, outgoingPortIndex);
 }
 
 void MegaMerger::sendYes(int port) {
-  if (port != outgoingPortIndex) {
-    auto yes = new Msg("yes", EventKind::YES);
-    send(yes, out, port);
-  }
+  auto yes = signalPool.acquire();
+  yes->setName("yes");
+  yes->setKind(EventKind::YES);
+  send(yes, out, port);
 }
 
 void MegaMerger::sendNo(int port) {
-  if (port != outgoingPortIndex) {
-    auto no = new Msg("no", EventKind::NO);
+  if (!isQuerying(port)) {
+    auto no = signalPool.acquire();
+    no->setName("no");
+    no->setKind(EventKind::NO);
     send(no, out, port);
   }
 }
 
 void MegaMerger::sendCheck(int port, bool changeStatus) {
-  auto check = new CheckMsg;
+  auto check = checkPool.acquire();
   check->setCid(cid);
   check->setLevel(level);
   check->setUpdateStatus(changeStatus);
@@ -138,10 +217,10 @@ void MegaMerger::sendCheck(int port, bool changeStatus) {
 }
 
 void MegaMerger::broadcastHello() {
-  auto hello = new HelloMsg;
+  auto hello = helloPool.acquire();
   hello->setUid(uid);
   for (int i = 1; i < neighborhoodSize; i++) 
-      send(hello->dup(), out, i);
+      send(helloPool.copy(*hello), out, i);
   send(hello, out, 0);
 }
 
@@ -149,7 +228,7 @@ void MegaMerger::broadcastCheck(bool changeStatus, CheckMsg* msg) {
   int arrivalGate;
   if (!msg) {
     arrivalGate = -1;
-    msg = new CheckMsg;
+    msg = checkPool.acquire();
     msg->setLevel(level);
     msg->setCid(cid);
     msg->setUpdateStatus(changeStatus);
@@ -158,20 +237,19 @@ void MegaMerger::broadcastCheck(bool changeStatus, CheckMsg* msg) {
     arrivalGate = msg->getArrivalGate()->getIndex();
   for (auto& neighbor : tree)
     if (neighbor != arrivalGate)
-      send(msg->dup(), out, neighbor);
-  delete msg;
+      send(checkPool.copy(*msg), out, neighbor);
+  checkPool.release(msg);
 }
 
 void MegaMerger::downstremBroadcastTermination(Msg* termination) {
-  if (!termination)
-    termination = new omnetpp::cMessage("termination", EventKind::TERMINATION);
+  if (!termination) {
+    termination = signalPool.acquire();
+    termination->setName("termination");
+    termination->setKind(EventKind::TERMINATION);
+  }
   localMulticast(termination, children);
 }
 
-void MegaMerger::updateNeighborCacheEntry(int portNumber, CacheEntry& entry) {
-  neighborCache[portNumber] = std::move(entry);
-}
-
 void MegaMerger::startUpdating() {
   expectedContactPointUid = -1;
   contactPointId = -1;
@@ -199,13 +277,15 @@ void MegaMerger::startConvergecast() {
         outgoingPortIndex = (*it)->getArrivalGate()->getIndex();
         contactPointId = (*it)->getUid();
       }
-      delete (*it);
+      minPool.release(*it);
       it = minCache.erase(it);
       minCounter++;
     }
     if (minCounter == children.size()) {
       convergecast();
     }
+    else
+      status = Status::PROCESSING;
   }
   else
     status = Status::PROCESSING;
@@ -222,17 +302,119 @@ void MegaMerger::convergecast() {
     get<Index::WEIGHT>(outgoingLink) == std::numeric_limits<double>::infinity()
   ) {
     downstremBroadcastTermination();
+    recordTermination();
     status = Status::LEADER;
   }
   else {
     isConvergecastFinished = true;
-    if (contactPointId == uid)
-      expectedContactPointUid = std::get<Index::NID>(neighborCache[outgoingPortIndex]);
     forwardRequest();
     status = Status::CONNECTING;
+    if (contactPointId == uid) {
+      expectedContactPointUid = neighborCache.nid(outgoingPortIndex);
+      mergePendingRequest();
+    }
   }
 }
 
+void MegaMerger::mergePendingRequest() {
+  ReqMsg* req = reqCache.take(expectedContactPointUid);
+  if (!req)
+    return;
+  // A request from a higher level is answered by absorbing this cluster
+  if (req->getLevel() == level) {
+    updateClusterState(req);
+    attendPendingRequest();
+    replyPendingQueryMsg();
+    if (unknownLinkCnt > 0) {
+      computeOutgoingLink();
+      startUpdating();
+      isConvergecastFinished = false;
+      status = Status::UPDATING;
+    }
+    else {
+      setInfinityWeight();
+      isConvergecastFinished = false;
+      startConvergecast();
+    }
+  }
+  reqPool.release(req);
+}
+
+void MegaMerger::runOracle() {
+  std::vector<MegaMerger*> nodes(getVectorSize(), nullptr);
+  std::vector<Oracle::Link> links;
+  // Submodules are walked once, looking them up by index is linear in 5.x
+  omnetpp::cModule* network = getParentModule();
+  for (omnetpp::cModule::SubmoduleIterator it(network); !it.end(); ++it)
+    if ((*it)->isName(getName()))
+      nodes[(*it)->getIndex()] = dynamic_cast<MegaMerger*>(*it);
+  for (int x = 0; x < (int)nodes.size(); x++) {
+    if (!nodes[x]) {
+      EV_WARN << "The oracle skips the verification, node[" << x
+              << "] is not a local Mega-Merger node\n";
+      return;
+    }
+    for (int p = 0; p < nodes[x]->neighborhoodSize; p++) {
+      int y = nodes[x]->getNeighbor(p)->getIndex();
+      if (x < y)
+        links.emplace_back(nodes[x]->getLinkWeight(p), x, y);
+    }
+  }
+  Oracle oracle(nodes.size(), std::move(links));
+  int mismatches = verify(oracle, nodes);
+  if (mismatches > 0)
+    throw omnetpp::cRuntimeError(
+      "MegaMerger: the oracle found %d wrong results, see the log", mismatches
+    );
+}
+
+int MegaMerger::verify(
+  const Oracle& oracle, const std::vector<MegaMerger*>& nodes
+) {
+  // Every branch is listed by both ends, so the ones listed once are wrong
+  std::vector<Oracle::Endpoints> listed;
+  for (auto node : nodes)
+    for (int p = 0; p < node->neighborhoodSize; p++)
+      if (node->neighborCache.kind(p) == LinkKind::BRANCH) {
+        int x = node->getIndex();
+        int y = node->getNeighbor(p)->getIndex();
+        listed.emplace_back(std::min(x, y), std::max(x, y));
+      }
+  std::sort(listed.begin(), listed.end());
+  std::vector<Oracle::Endpoints> tree;
+  int mismatches = 0;
+  for (std::size_t i = 0; i < listed.size(); ) {
+    std::size_t j = i;
+    while (j < listed.size() && listed[j] == listed[i])
+      j++;
+    if (j - i != 2) {
+      EV_ERROR << "Oracle: link (" << listed[i].first << ", "
+               << listed[i].second << ") is a branch at one end only\n";
+      mismatches++;
+    }
+    tree.push_back(listed[i]);
+    i = j;
+  }
+  auto forest = oracle.spanningForest();
+  std::vector<Oracle::Endpoints> wrong;
+  std::set_symmetric_difference(
+    tree.begin(), tree.end(), forest.begin(), forest.end(),
+    std::back_inserter(wrong)
+  );
+  for (auto& link : wrong)
+    EV_ERROR << "Oracle: link (" << link.first << ", " << link.second
+             << ") is a branch of one spanning tree only\n";
+  mismatches += wrong.size();
+  recordScalar("oracleTreeLinks", forest.size());
+  recordScalar("oracleTreeMismatches", mismatches);
+  return mismatches;
+}
+
+void MegaMerger::recordTermination() {
+  mstTime = omnetpp::simTime();
+  maxNetworkScalar("mstTime", SIMTIME_DBL(mstTime));
+}
+
 void MegaMerger::setInfinityWeight() {
   using std::get;
   get<Index::WEIGHT>(outgoingLink) = std::numeric_limits<double>::infinity();
@@ -242,22 +424,18 @@ void MegaMerger::setInfinityWeight() {
 }
 
 void MegaMerger::computeOutgoingLink() {
-  using std::get;
   setInfinityWeight();
-  int i = 0;
-  for (auto& entry : neighborCache) {
-    if (get<Index::KIND>(entry) == LinkKind::UNKNOWN) {
-      auto link = std::make_tuple(
-        get<Index::WEIGHT>(entry),
-        get<Index::MIN_ID>(entry),
-        get<Index::MAX_ID>(entry)
-      );
-      if (link < outgoingLink) {
-        updateMinOutgoingLink(link);
-        outgoingPortIndex = i;
-      }
+  int i = neighborCache.findMinCandidate();
+  if (i >= 0) {
+    Link link(
+      neighborCache.weight(i),
+      neighborCache.minUid(i),
+      neighborCache.maxUid(i)
+    );
+    if (link < outgoingLink) {
+      updateMinOutgoingLink(link);
+      outgoingPortIndex = i;
     }
-    i++;
   }
 }
 
@@ -268,18 +446,18 @@ void MegaMerger::updateMinOutgoingLink(Link& link) {
   get<Index::MAX_ID>(outgoingLink) = get<Index::MAX_ID>(link);
 }
 
-void MegaMerger::fillCacheEntry(
-  CacheEntry& entry, HelloMsg* hello, LinkKind kind
-) {
-  using std::get;
+void MegaMerger::fillCacheEntry(HelloMsg* hello, LinkKind kind) {
   int arrivalGate = hello->getArrivalGate()->getIndex();
-  get<Index::WEIGHT>(entry) = getLinkWeight(out, arrivalGate);
-  get<Index::MIN_ID>(entry) = (hello->getUid() < uid) ? hello->getUid() : uid;
-  get<Index::MAX_ID>(entry) = (hello->getUid() > uid) ? hello->getUid() : uid;
-  get<Index::NID>(entry) = hello->getUid();
-  get<Index::CID>(entry) = hello->getUid();
-  get<Index::PORT>(entry) = arrivalGate;
-  get<Index::KIND>(entry) = kind;
+  neighborCache.set(
+    arrivalGate,
+    getLinkWeight(arrivalGate),
+    (hello->getUid() < uid) ? hello->getUid() : uid,
+    (hello->getUid() > uid) ? hello->getUid() : uid,
+    hello->getUid(),
+    hello->getUid(),
+    arrivalGate,
+    kind
+  );
 }
 
 void MegaMerger::updateClusterState(ReqMsg* req) {
@@ -287,64 +465,59 @@ void MegaMerger::updateClusterState(ReqMsg* req) {
   if (level == req->getLevel()) {
     level++;
     core = uid < req->getContactPointId();
+    if (core)
+      merges++;
     cid = (core) ? uid : req->getContactPointId();
+    // The path to the former core is reversed
+    if (parent >= 0)
+      children.push_back(parent);
     parent = (core) ? -1 : outgoingPortIndex;
     if (core) children.push_back(outgoingPortIndex);
-    std::get<Index::CID>(neighborCache[outgoingPortIndex]) = cid;
+    neighborCache.setCid(outgoingPortIndex, cid);
   }
   // Case AnswerQuery by neighboring cluster
   else if (level < req->getLevel()) {
     level = req->getLevel();
     cid = req->getCid();
     core = false;
+    if (parent >= 0)
+      children.push_back(parent);
     parent = outgoingPortIndex;
-    std::get<Index::CID>(neighborCache[outgoingPortIndex]) = cid;
+    neighborCache.setCid(outgoingPortIndex, cid);
   }
   broadcastCheck(true);
   tree.push_back(outgoingPortIndex);
-  std::get<Index::KIND>(neighborCache[outgoingPortIndex]) = LinkKind::BRANCH;
+  neighborCache.setKind(outgoingPortIndex, LinkKind::BRANCH);
   unknownLinkCnt--;
 }
 
 void MegaMerger::replyPendingQueryMsg() {
-  int arrivalGate;
-  auto it = queryCache.begin();
-  while (it != queryCache.end()) {
-    arrivalGate = (*it)->getArrivalGate()->getIndex();
-    if (level >= (*it)->getLevel()) {
-      if (cid == (*it)->getCid()) {
-        std::get<Index::KIND>(neighborCache[arrivalGate]) = LinkKind::INTERNAL;
+  queryCache.releaseUpTo(level, [this](QueryMsg* query) {
+    int arrivalGate = query->getArrivalGate()->getIndex();
+    // A query whose link became a branch while it waited needs no reply
+    if (neighborCache.kind(arrivalGate) != LinkKind::BRANCH) {
+      if (cid == query->getCid()) {
+        neighborCache.setKind(arrivalGate, LinkKind::INTERNAL);
         unknownLinkCnt--;
         sendNo(arrivalGate);
       }
       else
         sendYes(arrivalGate);
-      delete (*it);
-      it = queryCache.erase(it);
     }
-    else 
-      ++it;
-  }
+    queryPool.release(query);
+  });
 }
 
-void MegaMerger::attendPendingRequest() {
-  if (!reqCache.empty()) {
-    auto it = reqCache.begin();
-    while (it != reqCache.end()) {
-      if ((*it)->getLevel() < level) {
-        int arrivalGate = (*it)->getArrivalGate()->getIndex();
-        std::get<Index::KIND>(neighborCache[arrivalGate]) = LinkKind::BRANCH;
-        unknownLinkCnt--;
-        tree.push_back(arrivalGate);
-        children.push_back(arrivalGate);
-        sendCheck(arrivalGate, true);
-        delete (*it);
-        it = reqCache.erase(it);
-      }
-      else
-        it++;
-    }
-  }
+void MegaMerger::attendPendingRequest(bool changeStatus) {
+  reqCache.releaseBelow(level, [this, changeStatus](ReqMsg* req) {
+    int arrivalGate = req->getArrivalGate()->getIndex();
+    neighborCache.setKind(arrivalGate, LinkKind::BRANCH);
+    unknownLinkCnt--;
+    tree.push_back(arrivalGate);
+    children.push_back(arrivalGate);
+    sendCheck(arrivalGate, changeStatus);
+    reqPool.release(req);
+  });
 }
 
 void MegaMerger::initializeNodeState() {
@@ -356,36 +529,54 @@ void MegaMerger::initializeNodeState() {
 
 void MegaMerger::tryAbsorption(ReqMsg* req) {
   int arrivalGate = req->getArrivalGate()->getIndex();
-  bool isBranch = (level == 0) ? false : req->getContactPointId() == 
-    std::get<Index::NID>(neighborCache[outgoingPortIndex]);
   // Case absortion
   if (level > req->getLevel()) {
-    if (isBranch) {
-      std::get<Index::KIND>(neighborCache[arrivalGate]) = LinkKind::BRANCH;
-      unknownLinkCnt--;
-      tree.push_back(arrivalGate);
-      children.push_back(arrivalGate);
+    absorptions++;
+    bool isQueried = isQuerying(arrivalGate);
+    bool isRequested = status == Status::CONNECTING &&
+      expectedContactPointUid == req->getContactPointId();
+    neighborCache.setKind(arrivalGate, LinkKind::BRANCH);
+    unknownLinkCnt--;
+    tree.push_back(arrivalGate);
+    children.push_back(arrivalGate);
+    // The link this cluster requested is now a branch, the cluster starts
+    // a new phase rooted at this node
+    if (isRequested) {
+      if (parent >= 0)
+        children.push_back(parent);
+      parent = -1;
+      core = true;
+      broadcastCheck(true);
       if (unknownLinkCnt > 0) {
         computeOutgoingLink();
-        sendQuery();
+        startUpdating();
+        isConvergecastFinished = false;
+        status = Status::UPDATING;
       }
       else {
         setInfinityWeight();
+        isConvergecastFinished = false;
         startConvergecast();
       }
     }
-    else {
-      std::get<Index::KIND>(neighborCache[arrivalGate]) = LinkKind::BRANCH;
-      unknownLinkCnt--;
-      tree.push_back(arrivalGate);
-      children.push_back(arrivalGate);
+    else
       sendCheck(arrivalGate, isConvergecastFinished ? false : true);
+    // The absorbed cluster answers the pending query on this link
+    if (isQueried) {
+      if (unknownLinkCnt > 0) {
+        computeOutgoingLink();
+        sendQuery();
+      }
+      else {
+        setInfinityWeight();
+        startConvergecast();
+      }
     }
-    delete req;
+    reqPool.release(req);
   }
   // Case merger or future absorption
   else
-    reqCache.push_back(req);
+    reqCache.push(req, req->getLevel(), req->getContactPointId());
 }
 
 void MegaMerger::WakingUp::operator()(Impulse* impulse) {
@@ -395,13 +586,9 @@ void MegaMerger::WakingUp::operator()(Impulse* impulse) {
   ap->status = Status::UPDATING;
 }
 
-void MegaMerger::BroadcastingHello::operator()(Msg* msg) {
-  auto hello = dynamic_cast<HelloMsg*>(msg);
-  int arrivalPort = hello->getArrivalGate()->getIndex();
-  CacheEntry entry;
+void MegaMerger::BroadcastingHello::operator()(HelloMsg* hello) {
   ap->initializeNodeState();
-  ap->fillCacheEntry(entry, hello, LinkKind::UNKNOWN);
-  ap->updateNeighborCacheEntry(arrivalPort, entry);
+  ap->fillCacheEntry(hello, LinkKind::UNKNOWN);
   ap->helloCounter = 1;
   ap->broadcastHello();
   // Transition to updating
@@ -412,36 +599,27 @@ void MegaMerger::BroadcastingHello::operator()(Msg* msg) {
     ap->computeOutgoingLink();
     ap->contactPointId = ap->uid;
     ap->expectedContactPointUid = 
-      std::get<Index::NID>(ap->neighborCache[ap->outgoingPortIndex]);
+      ap->neighborCache.nid(ap->outgoingPortIndex);
     ap->forwardRequest();
     ap->status = Status::CONNECTING;
   }
-  delete msg;
+  ap->helloPool.release(hello);
 }
 
-void MegaMerger::UpdatingCache::operator()(Msg* msg) {
-  auto hello = dynamic_cast<HelloMsg*>(msg);
-  int arrivalPort = hello->getArrivalGate()->getIndex();
-  CacheEntry entry;
-  ap->fillCacheEntry(entry, hello, LinkKind::UNKNOWN);
-  ap->updateNeighborCacheEntry(arrivalPort, entry);
+void MegaMerger::UpdatingCache::operator()(HelloMsg* hello) {
+  ap->fillCacheEntry(hello, LinkKind::UNKNOWN);
   ap->helloCounter++;
   // Transition to connecting
   if (ap->neighborhoodSize == ap->helloCounter) {
     ap->computeOutgoingLink();
     ap->contactPointId = ap->uid;
     ap->expectedContactPointUid = 
-      std::get<Index::NID>(ap->neighborCache[ap->outgoingPortIndex]);
-    auto it = std::find_if(
-      ap->reqCache.begin(), ap->reqCache.end(),
-      [&](ReqMsg* reqMsg) -> bool {
-        return reqMsg->getContactPointId() == ap->expectedContactPointUid;
-      } 
-    );
-    if (it != ap->reqCache.end()) { //Req is previosly received
+      ap->neighborCache.nid(ap->outgoingPortIndex);
+    ReqMsg* req = ap->reqCache.take(ap->expectedContactPointUid);
+    if (req) { //Req is previosly received
       ap->forwardRequest();
-      ap->updateClusterState(*it);
-      ap->reqCache.erase(it);
+      ap->updateClusterState(req);
+      ap->reqPool.release(req);
       ap->attendPendingRequest();
       ap->replyPendingQueryMsg();
       if (ap->unknownLinkCnt > 0) {
@@ -452,8 +630,8 @@ void MegaMerger::UpdatingCache::operator()(Msg* msg) {
       }
       else {
         ap->setInfinityWeight();
-        ap->startConvergecast();
         ap->isConvergecastFinished = false;
+        ap->startConvergecast();
       }
     }
     else {
@@ -461,13 +639,15 @@ void MegaMerger::UpdatingCache::operator()(Msg* msg) {
       ap->status = Status::CONNECTING;
     }
   }
-  delete msg;
+  ap->helloPool.release(hello);
 }
 
-void MegaMerger::ClusterMerger::operator()(Msg* msg) {
-  auto req = dynamic_cast<ReqMsg*>(msg);
+void MegaMerger::ClusterMerger::operator()(ReqMsg* req) {
   // Case Merger
-  if (ap->expectedContactPointUid == req->getContactPointId()) {
+  if (
+    ap->expectedContactPointUid == req->getContactPointId() &&
+    ap->level == req->getLevel()
+  ) {
     ap->updateClusterState(req);
     ap->attendPendingRequest();
     ap->replyPendingQueryMsg();
@@ -479,10 +659,10 @@ void MegaMerger::ClusterMerger::operator()(Msg* msg) {
     }
     else {
       ap->setInfinityWeight();
-      ap->startConvergecast();
       ap->isConvergecastFinished = false;
+      ap->startConvergecast();
     }
-    delete req;
+    ap->reqPool.release(req);
   }
   // Case Absorption
   else  {
@@ -490,39 +670,48 @@ void MegaMerger::ClusterMerger::operator()(Msg* msg) {
   }
 }
 
-void MegaMerger::TryingAbsorption::operator()(Msg* msg) {
-  auto req = dynamic_cast<ReqMsg*>(msg);
+void MegaMerger::TryingAbsorption::operator()(ReqMsg* req) {
   ap->tryAbsorption(req);
 }
 
-void MegaMerger::Expanding::operator()(Msg* msg) {
-  auto checkMsg = dynamic_cast<CheckMsg*>(msg);
+void MegaMerger::Expanding::operator()(CheckMsg* checkMsg) {
   bool updateStatus = checkMsg->getUpdateStatus();
   int  arrivalGate = checkMsg->getArrivalGate()->getIndex();
   ap->cid = checkMsg->getCid();
   ap->level = checkMsg->getLevel();
   ap->core = false;
-  std::get<Index::CID>(ap->neighborCache[arrivalGate]) = ap->cid;
+  ap->neighborCache.setCid(arrivalGate, ap->cid);
   if (
-    ap->expectedContactPointUid == 
-    std::get<Index::NID>(ap->neighborCache[arrivalGate])
+    ap->neighborCache.kind(arrivalGate) != LinkKind::BRANCH &&
+    ap->expectedContactPointUid == ap->neighborCache.nid(arrivalGate)
   ) { //Contact
+    if (ap->parent >= 0)
+      ap->children.push_back(ap->parent);
     ap->parent = arrivalGate;
     ap->tree.push_back(arrivalGate);
-    std::get<Index::KIND>(ap->neighborCache[arrivalGate]) =
-      LinkKind::BRANCH;
+    ap->neighborCache.setKind(arrivalGate, LinkKind::BRANCH);
     ap->unknownLinkCnt--;
+    // The request this cluster sent the other way is answered by the check
+    if (ReqMsg* req = ap->reqCache.take(ap->expectedContactPointUid))
+      ap->reqPool.release(req);
   }
   else {
     auto it = std::find(ap->children.begin(), ap->children.end(), arrivalGate);
     // Message comes from a child
     if (it != ap->children.end()) {
-      *it = ap->parent; //parent becomes child
+      if (ap->parent >= 0)
+        *it = ap->parent; //parent becomes child
+      else
+        ap->children.erase(it); //the core has no parent
       ap->parent = arrivalGate; //child becomes parent
     }
   }
   ap->broadcastCheck(updateStatus, checkMsg);
-  ap->attendPendingRequest();
+  // A node left out of the running phase, and the clusters it absorbs, wait
+  // for the next one
+  if (!updateStatus)
+    ap->isConvergecastFinished = true;
+  ap->attendPendingRequest(updateStatus);
   ap->replyPendingQueryMsg();
   if (updateStatus) {
     if (ap->unknownLinkCnt > 0) {
@@ -533,80 +722,51 @@ void MegaMerger::Expanding::operator()(Msg* msg) {
     }
     else {
       ap->setInfinityWeight();
-      ap->startConvergecast();
       ap->isConvergecastFinished = false;
+      ap->startConvergecast();
     }
   }
 }
 
-void MegaMerger::ReplyingQuery::operator()(Msg* msg) {
-  auto query = dynamic_cast<QueryMsg*>(msg);
+void MegaMerger::ReplyingQuery::operator()(QueryMsg* query) {
   int arrivalGate = query->getArrivalGate()->getIndex();
-  std::get<Index::CID>(ap->neighborCache[arrivalGate]) = ap->cid;
+  ap->neighborCache.setCid(arrivalGate, ap->cid);
   if (query->getCid() == ap->cid) {
-    std::get<Index::KIND>(ap->neighborCache[arrivalGate]) = LinkKind::INTERNAL;
+    ap->neighborCache.setKind(arrivalGate, LinkKind::INTERNAL);
     ap->unknownLinkCnt--;
-    ap->sendNo(arrivalGate);
-    if (ap->unknownLinkCnt == 0) {
-      ap->setInfinityWeight();
-      ap->startConvergecast();
-    }
-    else if (arrivalGate == ap->outgoingPortIndex) {
-      ap->computeOutgoingLink();
-      ap->startUpdating();
-      ap->isConvergecastFinished = false;
-      ap->status = Status::UPDATING;
+    // Crossing queries: both ends learn the link is internal
+    if (ap->isQuerying(arrivalGate)) {
+      if (ap->unknownLinkCnt > 0) {
+        ap->computeOutgoingLink();
+        ap->sendQuery();
+      }
+      else {
+        ap->setInfinityWeight();
+        ap->startConvergecast();
+      }
     }
-    delete query;
+    else
+      ap->sendNo(arrivalGate);
+    ap->queryPool.release(query);
   }
   else if (ap->level >= query->getLevel()) {
     ap->sendYes(arrivalGate);
-    delete query;
-  }
-  else if ( // Overlap previous req with Q
-    arrivalGate == ap->outgoingPortIndex
-  ) {
-    ap->cid = query->getCid();
-    ap->level = query->getLevel();
-    ap->core = false;
-    ap->parent = arrivalGate;
-    ap->broadcastCheck(true);
-    ap->tree.push_back(arrivalGate);
-    std::get<Index::KIND>(ap->neighborCache[arrivalGate]) =
-      LinkKind::BRANCH;
-    ap->unknownLinkCnt--;
-    ap->attendPendingRequest();
-    ap->replyPendingQueryMsg();
-    if (ap->unknownLinkCnt > 0) {
-      ap->computeOutgoingLink();
-      ap->startUpdating();
-      ap->isConvergecastFinished = false;
-      ap->status = Status::UPDATING;
-    }
-    else {
-      ap->setInfinityWeight();
-      ap->startConvergecast();
-      ap->isConvergecastFinished = false;
-    }
-    delete query;
+    ap->queryPool.release(query);
   }
   else
-    ap->queryCache.push_back(query);
+    ap->queryCache.push(query, query->getLevel());
 }
 
 void MegaMerger::ProcessingYes::operator()(Msg* msg) {
-  using std::get;
-  int arrivalGate = msg->getArrivalGate()->getIndex();
-  ap->expectedContactPointUid = get<Index::NID>(ap->neighborCache[arrivalGate]);
   ap->contactPointId = ap->uid;
   ap->startConvergecast();
-  delete msg;
+  ap->signalPool.release(msg);
 }
 
 void MegaMerger::ProcessingNo::operator()(Msg* msg) {
   using std::get;
   int arrivalGate = msg->getArrivalGate()->getIndex();
-  std::get<Index::KIND>(ap->neighborCache[arrivalGate]) = LinkKind::INTERNAL;
+  ap->neighborCache.setKind(arrivalGate, LinkKind::INTERNAL);
   ap->unknownLinkCnt--;
   if (ap->unknownLinkCnt > 0) {
     ap->computeOutgoingLink();
@@ -616,16 +776,14 @@ void MegaMerger::ProcessingNo::operator()(Msg* msg) {
     ap->setInfinityWeight();
     ap->startConvergecast();
   }
-  delete msg;
+  ap->signalPool.release(msg);
 }
 
-void MegaMerger::CachingMinimum::operator()(Msg* msg) {
-  auto min = dynamic_cast<MinMsg*>(msg);
+void MegaMerger::CachingMinimum::operator()(MinMsg* min) {
   ap->minCache.push_back(min);
 }
 
-void MegaMerger::ComputingMinimum::operator()(Msg* msg) {
-  auto minMsg = dynamic_cast<MinMsg*>(msg);
+void MegaMerger::ComputingMinimum::operator()(MinMsg* minMsg) {
   auto link = std::make_tuple(
     minMsg->getWeight(),
     minMsg->getMinUid(),
@@ -634,53 +792,27 @@ void MegaMerger::ComputingMinimum::operator()(Msg* msg) {
   if (link < ap->outgoingLink) {
     ap->updateMinOutgoingLink(link);
     ap->outgoingPortIndex = minMsg->getArrivalGate()->getIndex();
-    ap->contactPointId = minMsg->getId();
+    ap->contactPointId = minMsg->getUid();
   }
   ap->minCounter++;
   if (ap->minCounter == ap->children.size()) {
     ap->convergecast();
   }
-  delete minMsg;
+  ap->minPool.release(minMsg);
 }
 
 void MegaMerger::Solving::operator()(Msg* msg) {
   ap->downstremBroadcastTermination(msg);
+  ap->recordTermination();
   ap->status = Status::FOLLOWER;
 }
 
-void MegaMerger::ForwardingRequest::operator()(Msg* msg) {
-  auto req = dynamic_cast<ReqMsg*>(msg);
+void MegaMerger::ForwardingRequest::operator()(ReqMsg* req) {
   if (req->getContactPointId() == ap->uid) {
     ap->expectedContactPointUid = 
-      std::get<Index::NID>(ap->neighborCache[ap->outgoingPortIndex]);
-    auto it = find_if (
-      ap->reqCache.begin(),
-      ap->reqCache.end(),
-      [&](ReqMsg* reqMsg) -> bool {
-        return ap->expectedContactPointUid == reqMsg->getContactPointId();
-      }
-    );
-    if (it != ap->reqCache.end()) {
-      delete *it;
-      ap->reqCache.erase(it);
-      ap->updateClusterState(req);
-      ap->attendPendingRequest();
-      ap->replyPendingQueryMsg();
-      if (ap->unknownLinkCnt > 0) {
-        ap->computeOutgoingLink();
-        ap->startUpdating();
-        ap->isConvergecastFinished = false;
-        ap->status = Status::UPDATING;
-      }
-      else {
-        ap->setInfinityWeight();
-        ap->startConvergecast();
-        ap->isConvergecastFinished = false;
-      }
-    }
-    else {
-      ap->forwardRequest(req);
-    }
+      ap->neighborCache.nid(ap->outgoingPortIndex);
+    ap->forwardRequest(req);
+    ap->mergePendingRequest();
   }
   else
     ap->forwardRequest(req);
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <array>
+#include <iterator>
 #include <tuple>
 #include <vector>
 
@@ -27,6 +28,18 @@
 #include "MinMsg_m.h"
 #include "ReqMsg_m.h"
 #include "CheckMsg_m.h"
+#include "MessagePool.h"
+#include "ProtocolSpec.h"
+#include "NeighborCache.h"
+#include "PendingCache.h"
+#include "Oracle.h"
+
+template <> struct MessageOf<EventKind::HELLO> { typedef HelloMsg type; };
+template <> struct MessageOf<EventKind::QUERY> { typedef QueryMsg type; };
+template <> struct MessageOf<EventKind::FWD> { typedef ReqMsg type; };
+template <> struct MessageOf<EventKind::REQ> { typedef ReqMsg type; };
+template <> struct MessageOf<EventKind::CHECK> { typedef CheckMsg type; };
+template <> struct MessageOf<EventKind::MIN> { typedef MinMsg type; };
 
 /** @brief This class describes the procedures and elements of nodes obeying
  *  the Mega-Merger protocol. All members of this class must be public in order
@@ -35,11 +48,6 @@
 */
 class MegaMerger : public BaseNode {
 public:
-  /** @brief A neighbor cache entry composed for these elements: the weight, 
-   *  the min uid, the max uid, the neighbor ID, the cluster id, the level, the port, and
-   *  the kind of link. 
-   */
-  typedef std::tuple<double, int, int, int, int, int, int> CacheEntry;
   /** @brief A triple of kind <weight, minUid, maxUid> */
   typedef std::tuple<double, int, int> Link;
   /** @brief Default constructor */
@@ -55,15 +63,21 @@ public:
     * registers the rules this node obeys
     */
   virtual void initialize() override;
+  /** @brief Records the message counts, the merges, the final level and the
+   *  statistics of the message pools */
+  virtual void finish() override;
+  /** @brief Returns the size of the fields of a Mega-Merger message */
+  virtual long payloadSize(const omnetpp::cMessage*) const override;
+  /** @brief Copies a message from the pool of its kind */
+  virtual omnetpp::cMessage* replicate(omnetpp::cMessage*) override;
+  /** @brief Gives a message back to the pool of its kind */
+  virtual void recycle(omnetpp::cMessage*) override;
 protected:
+  /** @brief The fields of a Link */
   enum Index {
     WEIGHT = 0, // The weight of the link
     MIN_ID,     // The min uid 
-    MAX_ID,     // The max uid
-    NID,        // The neighbor ID
-    CID,        // The cluster ID of the neighbor
-    PORT,       // The port of the neighbor
-    KIND        // The kind of link
+    MAX_ID      // The max uid
   };
   enum LinkKind {
     INTERNAL = 0, // A link that belongs the node's cluster, but not a branch
@@ -79,16 +93,17 @@ protected:
    *  number of port of children, not the uid.
    */
   std::vector<int> children;
-  /** @brief Holds the port number, the id, the cid, the level and the kind of
-   * link of a neighbor from N(x)
+  /** @brief Holds the link weight, the uids, the id, the cid, the port and
+   *  the kind of link of each neighbor from N(x), indexed by port. The
+   *  candidates of the outgoing link are the UNKNOWN links.
    */
-  std::vector<CacheEntry> neighborCache;
+  NeighborCache neighborCache;
   /** @brief This data structure stores request messages from neighboring 
-   *  clusters */
-  std::vector<ReqMsg*> reqCache;
-  /** @brief This data structure stores request messages from neighboring 
-   *  clusters */
-  std::vector<QueryMsg*> queryCache;
+   *  clusters, indexed by contact point and bucketed by level */
+  PendingCache<ReqMsg> reqCache;
+  /** @brief This data structure stores query messages from neighboring 
+   *  clusters, bucketed by level */
+  PendingCache<QueryMsg> queryCache;
   /** @brief This data structure stores unexpected minimum messages */
   std::vector<MinMsg*> minCache;
   /** @brief The UID of the contact from the neighboring cluster.
@@ -107,6 +122,11 @@ protected:
   int parent;
   /** @brief The number of friendly merging this cluster performs */
   int level;
+  /** @brief The number of fusions this node commits as the new core and the
+   *  number of clusters it absorbs as a contact point */
+  int merges = 0, absorptions = 0;
+  /** @brief The time this node learns the spanning tree is complete */
+  omnetpp::simtime_t mstTime = -1;
   /** @brief The number of hello messages this node receives */
   int helloCounter;
   /** @brief The number of min messages currently received */
@@ -119,6 +139,14 @@ protected:
   int contactPointId;
   /** @brief The current outgoing link that has the minimum local weight */
   Link outgoingLink;
+  /** @brief Pools recycling the messages of the protocol. Yes and no
+   *  messages share the signal pool */
+  MessagePool<HelloMsg> helloPool;
+  MessagePool<QueryMsg> queryPool;
+  MessagePool<MinMsg> minPool;
+  MessagePool<ReqMsg> reqPool;
+  MessagePool<CheckMsg> checkPool;
+  MessagePool<Msg> signalPool;
 protected:
   /** @brief Composes a request message, then, forwards it through the 
    *  outgoingPortIndex until reaching the contact point
@@ -163,6 +191,13 @@ protected:
   virtual void downstremBroadcastTermination(Msg* msg = nullptr);
   /** @brief Replies, if it is possible, query messages the query cache stores */
   virtual void replyPendingQueryMsg();
+  /** @brief Merges with the cluster whose request is cached for the link
+   *  this contact point has just requested */
+  virtual void mergePendingRequest();
+  /** @brief Whether a query sent through a port still awaits its answer */
+  bool isQuerying(int port) const {
+    return status == Status::UPDATING && port == outgoingPortIndex;
+  }
   /** @brief Starts a updating process to find the minimum-weight local edge */
   virtual void startUpdating();
   /** @brief Starts a convergecast process to compute the cluster-level 
@@ -180,26 +215,36 @@ protected:
    *  @param link A tuple of kind <weight, uid, uid>
   */
   virtual void updateMinOutgoingLink(Link&);
+  /** @brief Builds the oracle of the network from the links of every node
+   *  and checks the results of the protocol against it. Node 0 calls it in
+   *  finish() when the verify parameter is set. It throws an error if some
+   *  result is wrong and skips the check in parallel runs */
+  virtual void runOracle();
+  /** @brief Checks that the branches of the nodes are the links of the
+   *  minimum spanning forest, and that both ends of a branch agree
+   *  @param first - the oracle
+   *  @param second - the nodes, indexed by uid
+   *  @return the number of mismatches
+   */
+  virtual int verify(const Oracle&, const std::vector<MegaMerger*>&);
+  /** @brief Notes the time this node learns the spanning tree is complete */
+  virtual void recordTermination();
   /** @brief Solves the merging process by comparing the level of an internal
    *  query with to level of an external query
    *  @param query An external query
    */
   virtual void updateClusterState(ReqMsg*);
-  /** @brief Fills the fields of a cache entry from a hello msg
-   *  @param entry a cache entry
+  /** @brief Fills the neighbor cache entry of the port a hello msg comes
+   *  from
    *  @param hello a hello message
    *  @parama linkKind the kind of the link
    */
-  virtual void fillCacheEntry(CacheEntry&, HelloMsg*, LinkKind);
-  /** @brief Updates an entry in neighborCache
-   *  @param index The index of the neighbor cache entry
-   *  @param hello A received hello message
-  */
-  virtual void updateNeighborCacheEntry(int, CacheEntry&);
+  virtual void fillCacheEntry(HelloMsg*, LinkKind);
   /** @brief Solves pending requests, if any. Such requests are responded with
    *  a check message.
+   *  @param changeStatus Whether the absorbed nodes join the current phase
    */
-  virtual void attendPendingRequest();
+  virtual void attendPendingRequest(bool changeStatus = true);
   /** @brief Initializes node-state variables */
   virtual void initializeNodeState();
   /** @brief Tries to absorb a neighboring cluster, otherwise, the req is
@@ -251,129 +296,104 @@ protected:
   class CachingMinimum;
   /** @brief Tries to absorb a neighboring cluster */
   class TryingAbsorption;
+  /** @brief The rules of the Mega-Merger protocol */
+  typedef ProtocolSpec<
+    Rule<Status::IDLE, EventKind::IMPULSE, WakingUp>,
+    Rule<Status::IDLE, EventKind::HELLO, BroadcastingHello>,
+    Rule<Status::CONNECTING, EventKind::REQ, ClusterMerger>,
+    Rule<Status::CONNECTING, EventKind::FWD, ForwardingRequest>,
+    Rule<Status::CONNECTING, EventKind::QUERY, ReplyingQuery>,
+    Rule<Status::CONNECTING, EventKind::CHECK, Expanding>,
+    Rule<Status::CONNECTING, EventKind::TERMINATION, Solving>,
+    Rule<Status::UPDATING, EventKind::HELLO, UpdatingCache>,
+    Rule<Status::UPDATING, EventKind::QUERY, ReplyingQuery>,
+    Rule<Status::UPDATING, EventKind::YES, ProcessingYes>,
+    Rule<Status::UPDATING, EventKind::NO, ProcessingNo>,
+    Rule<Status::UPDATING, EventKind::REQ, TryingAbsorption>,
+    Rule<Status::UPDATING, EventKind::MIN, CachingMinimum>,
+    Rule<Status::PROCESSING, EventKind::MIN, ComputingMinimum>,
+    Rule<Status::PROCESSING, EventKind::QUERY, ReplyingQuery>,
+    Rule<Status::PROCESSING, EventKind::REQ, TryingAbsorption>
+  > Protocol;
 };
 
-class MegaMerger::WakingUp : public BaseAction {
-private:
-  MegaMerger* ap;
+class MegaMerger::WakingUp : public Action<MegaMerger> {
 public:
-  WakingUp(MegaMerger* ptr) : BaseAction("WakingUp"), ap(ptr) { }
+  WakingUp(MegaMerger* ptr) : Action(ptr) { }
   void operator()(Impulse*);
 };
 
-class MegaMerger::BroadcastingHello : public BaseAction {
-private:
-  MegaMerger* ap;
+class MegaMerger::BroadcastingHello : public Action<MegaMerger> {
 public:
-  BroadcastingHello(MegaMerger* ptr) : BaseAction("BroadcastingHello"), ap(ptr) { }
-  void operator()(Msg*);
+  BroadcastingHello(MegaMerger* ptr) : Action(ptr) { }
+  void operator()(HelloMsg*);
 };
 
-class MegaMerger::UpdatingCache : public BaseAction {
-private:
-  MegaMerger* ap;
+class MegaMerger::UpdatingCache : public Action<MegaMerger> {
 public:
-  UpdatingCache(MegaMerger* ptr)
-    : BaseAction("UpdatingCache")
-    , ap(ptr)
-{ }
-  void operator()(Msg*);
+  UpdatingCache(MegaMerger* ptr) : Action(ptr) { }
+  void operator()(HelloMsg*);
 };
 
-class MegaMerger::ReplyingQuery : public BaseAction {
-private:
-  MegaMerger* ap;
+class MegaMerger::ReplyingQuery : public Action<MegaMerger> {
 public:
-  ReplyingQuery(MegaMerger* ptr) : BaseAction("ReplyingQuery"), ap(ptr) { }
-  void operator()(Msg*);
+  ReplyingQuery(MegaMerger* ptr) : Action(ptr) { }
+  void operator()(QueryMsg*);
 };
 
-class MegaMerger::ProcessingYes : public BaseAction {
-private:
-  MegaMerger* ap;
+class MegaMerger::ProcessingYes : public Action<MegaMerger> {
 public:
-  ProcessingYes(MegaMerger* ptr)
-    : BaseAction("ProcessingYes")
-    , ap(ptr)
-{ }
+  ProcessingYes(MegaMerger* ptr) : Action(ptr) { }
   void operator()(Msg*);
 };
 
-class MegaMerger::ProcessingNo : public BaseAction {
-private:
-  MegaMerger* ap;
+class MegaMerger::ProcessingNo : public Action<MegaMerger> {
 public:
-  ProcessingNo(MegaMerger* ptr)
-    : BaseAction("ProcessingNo")
-    , ap(ptr)
-{ }
+  ProcessingNo(MegaMerger* ptr) : Action(ptr) { }
   void operator()(Msg*);
 };
 
 
-class MegaMerger::ComputingMinimum : public BaseAction {
-private:
-  MegaMerger* ap;
+class MegaMerger::ComputingMinimum : public Action<MegaMerger> {
 public:
-  ComputingMinimum(MegaMerger* ptr) : BaseAction("ComputingMinimum"), ap(ptr) { }
-  void operator()(Msg*);
+  ComputingMinimum(MegaMerger* ptr) : Action(ptr) { }
+  void operator()(MinMsg*);
 };
 
-class MegaMerger::ClusterMerger : public BaseAction {
-private:
-  MegaMerger* ap;
+class MegaMerger::ClusterMerger : public Action<MegaMerger> {
 public:
-  ClusterMerger(MegaMerger* ptr) : BaseAction("ClusterMerger"), ap(ptr) { }
-  void operator()(Msg*);
+  ClusterMerger(MegaMerger* ptr) : Action(ptr) { }
+  void operator()(ReqMsg*);
 };
 
-class MegaMerger::Expanding : public BaseAction {
-private:
-  MegaMerger* ap;
+class MegaMerger::Expanding : public Action<MegaMerger> {
 public:
-  Expanding(MegaMerger* ptr) : BaseAction("Expanding"), ap(ptr) { }
-  void operator()(Msg*);
+  Expanding(MegaMerger* ptr) : Action(ptr) { }
+  void operator()(CheckMsg*);
 };
 
-class MegaMerger::Solving : public BaseAction {
-private:
-  MegaMerger* ap;
+class MegaMerger::Solving : public Action<MegaMerger> {
 public:
-  Solving(MegaMerger* ptr) : BaseAction("Solving"), ap(ptr) { }
-  virtual void operator()(Msg*);
+  Solving(MegaMerger* ptr) : Action(ptr) { }
+  void operator()(Msg*);
 };
 
-class MegaMerger::TryingAbsorption : public BaseAction {
-private:
-  MegaMerger* ap;
+class MegaMerger::TryingAbsorption : public Action<MegaMerger> {
 public:
-  TryingAbsorption(MegaMerger* ptr)
-    : BaseAction("TryingAbsorption")
-    , ap(ptr)
-{ }
-  void operator()(Msg*);
+  TryingAbsorption(MegaMerger* ptr) : Action(ptr) { }
+  void operator()(ReqMsg*);
 };
 
-class MegaMerger::ForwardingRequest : public BaseAction {
-private:
-  MegaMerger* ap;
+class MegaMerger::ForwardingRequest : public Action<MegaMerger> {
 public:
-  ForwardingRequest(MegaMerger* ptr)
-    : BaseAction("ForwardingRequest")
-    , ap(ptr)
-{ }
-  void operator()(Msg*);
+  ForwardingRequest(MegaMerger* ptr) : Action(ptr) { }
+  void operator()(ReqMsg*);
 };
 
-class MegaMerger::CachingMinimum : public BaseAction {
-private:
-  MegaMerger* ap;
+class MegaMerger::CachingMinimum : public Action<MegaMerger> {
 public:
-  CachingMinimum(MegaMerger* ptr)
-    : BaseAction("CachingMinimum")
-    , ap(ptr)
-{ }
-  void operator()(Msg*);
+  CachingMinimum(MegaMerger* ptr) : Action(ptr) { }
+  void operator()(MinMsg*);
 };
 
 
@@ -0,0 +1,92 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#if !defined(MESSAGE_POOL_H)
+#define MESSAGE_POOL_H
+
+#include <cstddef>
+#include <vector>
+
+/** @brief A free list of messages of type T. A node draws the messages it
+ *  sends from its pools and returns the messages it consumes to them, so
+ *  a message delivered to a node is recycled by that node instead of being
+ *  deleted. Recycled messages keep the values of their fields, hence
+ *  callers must set every field they use. The pool owns the messages it
+ *  holds, so it must be a member of the module owning them.
+ *  @author A.G. Medrano-Chavez
+ */
+template <typename T>
+class MessagePool {
+private:
+  std::vector<T*> pool;
+  /** @brief The maximum number of messages the pool holds */
+  std::size_t capacity;
+  /** @brief The number of acquisitions served by a recycled message */
+  unsigned long hits;
+  /** @brief The number of acquisitions served by a new message */
+  unsigned long misses;
+public:
+  explicit MessagePool(std::size_t capacity = 64)
+    : capacity(capacity)
+    , hits(0)
+    , misses(0)
+  { }
+  MessagePool(const MessagePool&) = delete;
+  MessagePool& operator=(const MessagePool&) = delete;
+  ~MessagePool() {
+    for (auto msg : pool)
+      delete msg;
+  }
+  /** @brief Returns a recycled message if any, otherwise a new one */
+  T* acquire() {
+    if (pool.empty()) {
+      misses++;
+      return new T;
+    }
+    hits++;
+    T* msg = pool.back();
+    pool.pop_back();
+    return msg;
+  }
+  /** @brief Returns a copy of a message, the copy is recycled if possible.
+   *  Only the envelope is copied, shared payloads stay shared */
+  T* copy(const T& original) {
+    T* msg = acquire();
+    *msg = original;
+    return msg;
+  }
+  /** @brief Gives a message back to the pool, it is deleted if the pool is
+   *  full */
+  void release(T* msg) {
+    if (pool.size() < capacity)
+      pool.push_back(msg);
+    else
+      delete msg;
+  }
+  /** @brief Changes the maximum number of messages the pool holds */
+  void setCapacity(std::size_t n) {
+    capacity = n;
+    while (pool.size() > capacity) {
+      delete pool.back();
+      pool.pop_back();
+    }
+  }
+  /** @brief Returns the number of messages held by the pool */
+  std::size_t size() const { return pool.size(); }
+  unsigned long getHits() const { return hits; }
+  unsigned long getMisses() const { return misses; }
+};
+
+#endif // MESSAGE_POOL_H
@@ -29,7 +29,7 @@
  * {
  *     name = "min";
  *     kind = EventKind::MIN;
- *     int uid; //The ID of the message composer
+ *     int uid; //The ID of the contact point of the link
  *     double weight;  // The weight of the link
  *     int minUid;     // The min UID of a link
  *     int maxUid;     // The max UID of a link
@@ -0,0 +1,42 @@
+#include "NeighborCache.h"
+
+#include <limits>
+
+void NeighborCache::assign(int n, int kind) {
+  weights.assign(n, std::numeric_limits<double>::infinity());
+  minUids.assign(n, std::numeric_limits<int>::max());
+  maxUids.assign(n, std::numeric_limits<int>::max());
+  nids.assign(n, -1);
+  cids.assign(n, -1);
+  ports.assign(n, -1);
+  kinds.assign(n, kind);
+  candidates = BinaryHeap<Key>(n);
+  for (int i = 0; i < n; i++)
+    updateCandidate(i);
+}
+
+void NeighborCache::set(
+  int i, double weight, int minUid, int maxUid, int nid, int cid, int port,
+  int kind
+) {
+  weights[i] = weight;
+  minUids[i] = minUid;
+  maxUids[i] = maxUid;
+  nids[i] = nid;
+  cids[i] = cid;
+  ports[i] = port;
+  kinds[i] = kind;
+  updateCandidate(i);
+}
+
+void NeighborCache::updateCandidate(int i) {
+  if (kinds[i] == candidateKind) {
+    Key key(weights[i], minUids[i], maxUids[i], i);
+    if (candidates.contains(i))
+      candidates.changeKey(i, key);
+    else
+      candidates.push(i, key);
+  }
+  else if (candidates.contains(i))
+    candidates.erase(i);
+}
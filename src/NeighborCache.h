@@ -0,0 +1,86 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+// 
+
+#if !defined(NEIGHBOR_CACHE_H)
+#define NEIGHBOR_CACHE_H
+
+#include <tuple>
+#include <vector>
+
+#include "PriorityQueue.h"
+
+/** @brief The neighbor cache of a Mega-Merger node, stored as a structure of
+ *  arrays indexed by port: the weight of the link, the min and max uid of its
+ *  endpoints, the uid and the cluster ID of the neighbor, the port and the
+ *  kind of the link. Entries of a given kind, the candidates, are kept in an
+ *  indexed min-heap keyed by (weight, minUid, maxUid, port), so changing the
+ *  kind of a link costs O(log d) and the minimum candidate is found in O(1).
+ *  @author A.G. Medrano-Chavez
+ */
+class NeighborCache {
+private:
+  /** @brief The key of a candidate, the port breaks ties */
+  typedef std::tuple<double, int, int, int> Key;
+  /** @brief The kind of the entries searched by findMinCandidate() */
+  int candidateKind;
+  std::vector<double> weights;
+  std::vector<int> minUids;
+  std::vector<int> maxUids;
+  std::vector<int> nids;
+  std::vector<int> cids;
+  std::vector<int> ports;
+  std::vector<signed char> kinds;
+  /** @brief The candidates */
+  BinaryHeap<Key> candidates;
+  /** @brief Queues, requeues or dequeues an entry after it changes */
+  void updateCandidate(int i);
+public:
+  /** @brief Builds an empty cache
+   *  @param candidateKind The kind of the entries searched for the minimum
+   */
+  explicit NeighborCache(int candidateKind)
+    : candidateKind(candidateKind)
+    , candidates(0)
+  { }
+  /** @brief Makes the cache hold n entries with infinite weight, the max
+   *  uids, no neighbor, no cluster, no port and a given kind */
+  void assign(int n, int kind);
+  /** @brief Returns the number of entries */
+  int size() const { return weights.size(); }
+  double weight(int i) const { return weights[i]; }
+  int minUid(int i) const { return minUids[i]; }
+  int maxUid(int i) const { return maxUids[i]; }
+  int nid(int i) const { return nids[i]; }
+  int cid(int i) const { return cids[i]; }
+  int port(int i) const { return ports[i]; }
+  int kind(int i) const { return kinds[i]; }
+  /** @brief Sets every field of an entry */
+  void set(
+    int i, double weight, int minUid, int maxUid, int nid, int cid, int port,
+    int kind
+  );
+  void setCid(int i, int cid) { cids[i] = cid; }
+  void setKind(int i, int kind) {
+    kinds[i] = kind;
+    updateCandidate(i);
+  }
+  /** @brief Returns the candidate with minimum (weight, minUid, maxUid), the
+   *  first one if there are ties, or -1 if there are no candidates */
+  int findMinCandidate() const {
+    return candidates.empty() ? -1 : candidates.top();
+  }
+};
+
+#endif // NEIGHBOR_CACHE_H
@@ -23,6 +23,7 @@
   #include <list>
   #include <memory>
   #include "Event.h"
+  #include "ParsimPacking.h"
   typedef std::tuple<int, int, double> NeighborhoodEntry;
   typedef std::shared_ptr<std::list<NeighborhoodEntry>> Neighborhood;
 // }}
@@ -0,0 +1,151 @@
+#include "NetworkBuilder.h"
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+Define_Module(NetworkBuilder);
+
+void NetworkBuilder::doBuildInside() {
+  omnetpp::cModule::doBuildInside();
+  if (par("model").stdstringValue() == "file") {
+    std::string format = par("format").stdstringValue();
+    EdgeListLoader::Format fileFormat;
+    if (format == "auto")
+      fileFormat = EdgeListLoader::Format::AUTO;
+    else if (format == "text")
+      fileFormat = EdgeListLoader::Format::TEXT;
+    else if (format == "binary")
+      fileFormat = EdgeListLoader::Format::BINARY;
+    else
+      throw omnetpp::cRuntimeError("NetworkBuilder: unknown format \"%s\"", format.c_str());
+    EdgeListLoader loader(
+      par("file").stdstringValue(), fileFormat, par("halve").boolValue()
+    );
+    EV_INFO << "NetworkBuilder: " << loader.size() << " nodes, "
+            << loader.getLinks() << " links, " << loader.getLoops()
+            << " self-loops skipped\n";
+    createNodes(loader.getDegrees());
+    loader.forEach([this](int u, int v, double w) { connect(u, v, w); });
+    nodes.clear();
+    ports.clear();
+    return;
+  }
+  long seed = par("seed").intValue();
+  if (seed < 0)
+    seed = intuniform(0, std::numeric_limits<int>::max() - 1);
+  TopologyGenerator generator(seed);
+  generate(generator);
+  std::string weights = par("weights").stdstringValue();
+  double minWeight = par("minWeight").doubleValue();
+  double maxWeight = par("maxWeight").doubleValue();
+  if (weights != "unit") {
+    if (!(minWeight >= 0) || std::isinf(minWeight))
+      throw omnetpp::cRuntimeError(
+        "NetworkBuilder: minWeight must be finite and non-negative, not %g",
+        minWeight
+      );
+    if (!(minWeight <= maxWeight) || std::isinf(maxWeight))
+      throw omnetpp::cRuntimeError(
+        "NetworkBuilder: maxWeight must be finite and at least minWeight, "
+        "not %g", maxWeight
+      );
+  }
+  if (weights == "unit")
+    generator.weigh(WeightKind::UNIT, 1.0, 1.0);
+  else if (weights == "uniform")
+    generator.weigh(WeightKind::UNIFORM, minWeight, maxWeight);
+  else if (weights == "integer") {
+    if (std::floor(maxWeight) - std::ceil(minWeight) + 1 <= 0)
+      throw omnetpp::cRuntimeError(
+        "NetworkBuilder: no integer weight lies in [%g, %g]",
+        minWeight, maxWeight
+      );
+    generator.weigh(WeightKind::INTEGER, minWeight, maxWeight);
+  }
+  else
+    throw omnetpp::cRuntimeError("NetworkBuilder: unknown weights \"%s\"", weights.c_str());
+  EV_INFO << "NetworkBuilder: " << generator.size() << " nodes, "
+          << generator.getEdges().size() << " links\n";
+  createNodes(generator.degrees());
+  auto& edges = generator.getEdges();
+  auto& weight = generator.getWeights();
+  for (std::size_t e = 0; e < edges.size(); e++)
+    connect(edges[e].first, edges[e].second, weight[e]);
+  nodes.clear();
+  ports.clear();
+}
+
+void NetworkBuilder::generate(TopologyGenerator& generator) {
+  std::string model = par("model").stdstringValue();
+  int n = par("n").intValue();
+  double degree = par("degree").doubleValue();
+  if (n <= 0)
+    throw omnetpp::cRuntimeError("NetworkBuilder: n must be positive");
+  if (model == "grid" || model == "torus") {
+    int columns = par("columns").intValue();
+    if (columns <= 0)
+      columns = std::max(1, int(std::sqrt(double(n))));
+    bool full = n % columns == 0 && columns >= 3 && n / columns >= 3;
+    if (model == "torus" && !full)
+      throw omnetpp::cRuntimeError(
+        "NetworkBuilder: a torus needs at least three full rows and columns"
+      );
+    generator.grid(n, columns, model == "torus");
+  }
+  else if (model == "tree")
+    generator.tree(n, std::max(1, int(std::lround(degree))));
+  else if (model == "rgg")
+    generator.geometric(n, degree);
+  else if (model == "er")
+    generator.erdosRenyi(n, degree);
+  else if (model == "ba")
+    generator.barabasiAlbert(n, std::max(1, int(std::lround(degree / 2))));
+  else
+    throw omnetpp::cRuntimeError("NetworkBuilder: unknown model \"%s\"", model.c_str());
+  if (par("connected").boolValue())
+    generator.connect();
+}
+
+void NetworkBuilder::createNodes(const std::vector<int>& degrees) {
+  std::string kind = par("kind").stdstringValue();
+  omnetpp::cModuleType* nodeType = omnetpp::cModuleType::find(kind.c_str());
+  if (!nodeType)
+    nodeType = omnetpp::cModuleType::find(("dsbase." + kind).c_str());
+  if (!nodeType)
+    throw omnetpp::cRuntimeError("NetworkBuilder: unknown kind \"%s\"", kind.c_str());
+  edgeType = omnetpp::cChannelType::get("dsbase.Edge");
+  int n = degrees.size();
+  nodes.resize(n);
+  ports.assign(n, 0);
+  for (int v = 0; v < n; v++) {
+    nodes[v] = nodeType->create("node", this, n, v);
+    nodes[v]->finalizeParameters();
+    nodes[v]->setGateSize("port", degrees[v]);
+    nodes[v]->buildInside();
+  }
+}
+
+void NetworkBuilder::connect(int u, int v, double weight) {
+  // Ports are taken in link order, so port i of a node is its i-th link
+  int i = ports[u]++;
+  int j = ports[v]++;
+  bool remoteU = nodes[u]->isPlaceholder();
+  bool remoteV = nodes[v]->isPlaceholder();
+  // As in NED-built networks, links between two remote nodes are omitted
+  // and a channel only exists where its source gate is local
+  if (remoteU && remoteV)
+    return;
+  omnetpp::cChannel* forward = nullptr;
+  omnetpp::cChannel* backward = nullptr;
+  if (!remoteU) {
+    forward = edgeType->create("channel");
+    forward->par("weight").setDoubleValue(weight);
+  }
+  if (!remoteV) {
+    backward = edgeType->create("channel");
+    backward->par("weight").setDoubleValue(weight);
+  }
+  nodes[u]->gate("port$o", i)->connectTo(nodes[v]->gate("port$i", j), forward);
+  nodes[v]->gate("port$o", j)->connectTo(nodes[u]->gate("port$i", i), backward);
+}
@@ -0,0 +1,57 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#if !defined(NETWORK_BUILDER_H)
+#define NETWORK_BUILDER_H
+
+#include <omnetpp.h>
+#include <vector>
+
+#include "EdgeListLoader.h"
+#include "TopologyGenerator.h"
+
+/** @brief A compound module that builds itself from parameters: it
+ *  generates a topology with TopologyGenerator, or loads it from an
+ *  edge-list file, and creates its node vector and Edge channels while the
+ *  network is set up, as if they were declared in NED. Hence, parameters of
+ *  the nodes are assigned in omnetpp.ini as usual and, under parallel
+ *  simulation, nodes outside the local partition become placeholders. The
+ *  gates of each node are sized from its degree beforehand, so gate vectors
+ *  never grow. Port i of a node is its i-th link in generation or file
+ *  order.
+ *  @author A.G. Medrano-Chavez
+ */
+class NetworkBuilder : public omnetpp::cModule {
+private:
+  /** @brief The node vector being built */
+  std::vector<omnetpp::cModule*> nodes;
+  /** @brief The next free port of each node */
+  std::vector<int> ports;
+  omnetpp::cChannelType* edgeType;
+protected:
+  /** @brief Builds the submodules declared in NED, if any, and then the
+   *  nodes and links given by the parameters */
+  virtual void doBuildInside() override;
+  /** @brief Generates the topology given by the parameters */
+  virtual void generate(TopologyGenerator& generator);
+  /** @brief Creates the nodes, their gate vectors hold degree[v] gates */
+  virtual void createNodes(const std::vector<int>& degrees);
+  /** @brief Links two nodes by a pair of Edge channels */
+  virtual void connect(int u, int v, double weight);
+public:
+  NetworkBuilder() : edgeType(nullptr) { }
+};
+
+#endif // NETWORK_BUILDER_H
@@ -0,0 +1,93 @@
+#include "Oracle.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+
+Oracle::Oracle(int size, std::vector<Link> l)
+  : n(size)
+  , links(std::move(l))
+  , offsets(size + 1, 0)
+{
+  links.erase(
+    std::remove_if(links.begin(), links.end(), [](const Link& link) {
+      return std::get<1>(link) == std::get<2>(link);
+    }),
+    links.end()
+  );
+  for (auto& link : links) {
+    if (std::get<1>(link) > std::get<2>(link))
+      std::swap(std::get<1>(link), std::get<2>(link));
+    offsets[std::get<1>(link) + 1]++;
+    offsets[std::get<2>(link) + 1]++;
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  targets.resize(offsets[n]);
+  weights.resize(offsets[n]);
+  std::vector<int> next(offsets.begin(), offsets.end() - 1);
+  for (auto& link : links) {
+    int u = std::get<1>(link);
+    int v = std::get<2>(link);
+    targets[next[u]] = v;
+    weights[next[u]++] = std::get<0>(link);
+    targets[next[v]] = u;
+    weights[next[v]++] = std::get<0>(link);
+  }
+}
+
+std::vector<Oracle::Endpoints> Oracle::spanningForest() const {
+  std::vector<Link> sorted(links);
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<int> root(n);
+  std::iota(root.begin(), root.end(), 0);
+  auto find = [&](int v) {
+    while (root[v] != v)
+      v = root[v] = root[root[v]];
+    return v;
+  };
+  std::vector<Endpoints> forest;
+  for (auto& link : sorted) {
+    int a = find(std::get<1>(link));
+    int b = find(std::get<2>(link));
+    if (a != b) {
+      root[std::max(a, b)] = std::min(a, b);
+      forest.emplace_back(std::get<1>(link), std::get<2>(link));
+    }
+  }
+  std::sort(forest.begin(), forest.end());
+  return forest;
+}
+
+std::vector<double> Oracle::distances(int source) const {
+  typedef std::pair<double, int> Entry;
+  std::vector<double> distance(n, std::numeric_limits<double>::infinity());
+  // Outdated entries are skipped instead of decreasing keys
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  distance[source] = 0.0;
+  queue.emplace(0.0, source);
+  while (!queue.empty()) {
+    Entry entry = queue.top();
+    queue.pop();
+    int u = entry.second;
+    if (entry.first > distance[u])
+      continue;
+    for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+      double d = entry.first + weights[e];
+      if (d < distance[targets[e]]) {
+        distance[targets[e]] = d;
+        queue.emplace(d, targets[e]);
+      }
+    }
+  }
+  return distance;
+}
+
+double Oracle::weight(int u, int v) const {
+  double w = std::numeric_limits<double>::infinity();
+  for (int e = offsets[u]; e < offsets[u + 1]; e++)
+    if (targets[e] == v)
+      w = std::min(w, weights[e]);
+  return w;
+}
@@ -0,0 +1,64 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+
+#if !defined(ORACLE_H)
+#define ORACLE_H
+
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/** @brief Sequential reference solutions the protocols are checked against
+ *  at the end of a run: the minimum spanning forest by Kruskal's algorithm
+ *  with union-find and the distances from a source by Dijkstra's algorithm
+ *  with a binary heap. Links are ordered as in Mega-Merger, by (weight,
+ *  min uid, max uid), so the forest is unique even if weights repeat.
+ *  @author A.G. Medrano-Chavez
+ */
+class Oracle {
+public:
+  /** @brief A link: weight, min uid, max uid */
+  typedef std::tuple<double, int, int> Link;
+  /** @brief The endpoints of a link: min uid, max uid */
+  typedef std::pair<int, int> Endpoints;
+private:
+  /** @brief The number of nodes */
+  int n;
+  std::vector<Link> links;
+  /** @brief The adjacency of the network in compressed sparse row format */
+  std::vector<int> offsets;
+  std::vector<int> targets;
+  std::vector<double> weights;
+public:
+  /** @brief Builds the oracle of a network
+   *  @param n The number of nodes, uids are 0..n-1
+   *  @param links Every link once, self-loops are ignored
+   */
+  Oracle(int n, std::vector<Link> links);
+  /** @brief Returns the number of nodes */
+  int size() const { return n; }
+  /** @brief Returns the links of the minimum spanning forest sorted by
+   *  endpoints */
+  std::vector<Endpoints> spanningForest() const;
+  /** @brief Returns the distance from a source to every node, infinity for
+   *  the unreachable ones */
+  std::vector<double> distances(int source) const;
+  /** @brief Returns the minimum weight of the links joining two nodes,
+   *  infinity if they are not adjacent */
+  double weight(int u, int v) const;
+};
+
+#endif // ORACLE_H
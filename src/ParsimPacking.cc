@@ -0,0 +1,166 @@
+#include "ParsimPacking.h"
+
+#include <functional>
+#include <utility>
+#include <unordered_map>
+#include <vector>
+
+namespace omnetpp {
+
+template <typename T>
+static void packVector(cCommBuffer* buffer, const std::vector<T>& v) {
+  buffer->pack(int(v.size()));
+  if (!v.empty())
+    buffer->pack(v.data(), v.size());
+}
+
+template <typename T>
+static std::vector<T> unpackVector(cCommBuffer* buffer) {
+  int n;
+  buffer->unpack(n);
+  std::vector<T> v(n);
+  if (n > 0)
+    buffer->unpack(v.data(), n);
+  return v;
+}
+
+template <typename T>
+static std::size_t hashVector(std::size_t seed, const std::vector<T>& v) {
+  std::hash<T> hash;
+  for (auto& x : v)
+    seed = seed * 1099511628211ull ^ hash(x);
+  return seed;
+}
+
+void doParsimPacking(
+  cCommBuffer* buffer, const std::shared_ptr<const CsrGraph>& graph
+) {
+  buffer->pack(bool(graph));
+  if (graph) {
+    packVector(buffer, graph->getOffsets());
+    packVector(buffer, graph->getTargets());
+    packVector(buffer, graph->getWeights());
+  }
+}
+
+void doParsimUnpacking(
+  cCommBuffer* buffer, std::shared_ptr<const CsrGraph>& graph
+) {
+  static std::unordered_multimap<std::size_t, std::weak_ptr<const CsrGraph>>
+    received;
+  bool present;
+  buffer->unpack(present);
+  if (!present) {
+    graph = nullptr;
+    return;
+  }
+  auto offsets = unpackVector<int>(buffer);
+  auto targets = unpackVector<int>(buffer);
+  auto weights = unpackVector<double>(buffer);
+  std::size_t key = 14695981039346656037ull;
+  key = hashVector(key, offsets);
+  key = hashVector(key, targets);
+  key = hashVector(key, weights);
+  auto range = received.equal_range(key);
+  for (auto it = range.first; it != range.second; ) {
+    auto known = it->second.lock();
+    if (!known)
+      it = received.erase(it);
+    else if (known->getOffsets() == offsets &&
+             known->getTargets() == targets &&
+             known->getWeights() == weights) {
+      graph = known;
+      return;
+    }
+    else
+      ++it;
+  }
+  graph = std::make_shared<const CsrGraph>(
+    std::move(offsets), std::move(targets), std::move(weights)
+  );
+  received.emplace(key, graph);
+}
+
+void doParsimPacking(
+  cCommBuffer* buffer, const std::shared_ptr<const RoutingBundle>& rows
+) {
+  buffer->pack(bool(rows));
+  if (!rows)
+    return;
+  int n = rows->forest->size();
+  buffer->pack(n);
+  packVector(buffer, rows->sources);
+  for (int source : rows->sources) {
+    RoutingRow row = rows->forest->row(source);
+    buffer->pack(row.prev, n);
+    buffer->pack(row.port, n);
+    buffer->pack(row.distance, n);
+  }
+}
+
+void doParsimUnpacking(
+  cCommBuffer* buffer, std::shared_ptr<const RoutingBundle>& rows
+) {
+  bool present;
+  buffer->unpack(present);
+  if (!present) {
+    rows = nullptr;
+    return;
+  }
+  int n;
+  buffer->unpack(n);
+  auto bundle = std::make_shared<RoutingBundle>();
+  bundle->sources = unpackVector<int>(buffer);
+  std::size_t count = bundle->sources.size();
+  std::vector<int> prev(count * n);
+  std::vector<int> port(count * n);
+  std::vector<double> distance(count * n);
+  for (std::size_t i = 0; i < count; i++) {
+    buffer->unpack(&prev[i * n], n);
+    buffer->unpack(&port[i * n], n);
+    buffer->unpack(&distance[i * n], n);
+  }
+  bundle->forest = std::make_shared<const AllPairsRouting>(
+    n, bundle->sources, std::move(prev), std::move(port), std::move(distance)
+  );
+  rows = bundle;
+}
+
+void doParsimPacking(
+  cCommBuffer* buffer,
+  const std::shared_ptr<std::list<std::tuple<int, int, double>>>& entries
+) {
+  buffer->pack(bool(entries));
+  if (entries) {
+    buffer->pack(int(entries->size()));
+    for (auto& entry : *entries) {
+      buffer->pack(std::get<0>(entry));
+      buffer->pack(std::get<1>(entry));
+      buffer->pack(std::get<2>(entry));
+    }
+  }
+}
+
+void doParsimUnpacking(
+  cCommBuffer* buffer,
+  std::shared_ptr<std::list<std::tuple<int, int, double>>>& entries
+) {
+  bool present;
+  buffer->unpack(present);
+  if (!present) {
+    entries = nullptr;
+    return;
+  }
+  int n;
+  buffer->unpack(n);
+  entries = std::make_shared<std::list<std::tuple<int, int, double>>>();
+  for (int i = 0; i < n; i++) {
+    std::tuple<int, int, double> entry;
+    buffer->unpack(std::get<0>(entry));
+    buffer->unpack(std::get<1>(entry));
+    buffer->unpack(std::get<2>(entry));
+    entries->push_back(entry);
+  }
+}
+
+} // namespace omnetpp
@@ -0,0 +1,66 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#if !defined(PARSIM_PACKING_H)
+#define PARSIM_PACKING_H
+
+#include <omnetpp.h>
+#include <list>
+#include <memory>
+#include <tuple>
+
+#include "AllPairsRouting.h"
+#include "CsrGraph.h"
+
+/* Serialization of the payloads messages share by pointer, so the messages
+ * may cross partitions under parallel simulation. The overloads live in the
+ * omnetpp namespace, as the generic ones of the generated _m.cc files, and
+ * being non-templates they take precedence over the generic ones, which
+ * throw. Include this file in the cplusplus block of a .msg file. */
+namespace omnetpp {
+
+/** @brief Packs a graph, a null pointer is sent as such */
+void doParsimPacking(
+  cCommBuffer* buffer, const std::shared_ptr<const CsrGraph>& graph
+);
+/** @brief Unpacks a graph. Equal graphs received by a partition are merged
+ *  into one object, so the routing forest of a graph, cached per object by
+ *  AllPairsRouting::obtain(), is computed once per partition */
+void doParsimUnpacking(
+  cCommBuffer* buffer, std::shared_ptr<const CsrGraph>& graph
+);
+/** @brief Packs a routing bundle, i.e., its sources and their rows but not
+ *  the rest of its forest */
+void doParsimPacking(
+  cCommBuffer* buffer, const std::shared_ptr<const RoutingBundle>& rows
+);
+/** @brief Unpacks a routing bundle, its forest holds the rows of its
+ *  sources alone */
+void doParsimUnpacking(
+  cCommBuffer* buffer, std::shared_ptr<const RoutingBundle>& rows
+);
+/** @brief Packs a list of neighborhood entries (uid, nid, weight) */
+void doParsimPacking(
+  cCommBuffer* buffer,
+  const std::shared_ptr<std::list<std::tuple<int, int, double>>>& entries
+);
+void doParsimUnpacking(
+  cCommBuffer* buffer,
+  std::shared_ptr<std::list<std::tuple<int, int, double>>>& entries
+);
+
+} // namespace omnetpp
+
+#endif // PARSIM_PACKING_H
@@ -0,0 +1,108 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#if !defined(PENDING_CACHE_H)
+#define PENDING_CACHE_H
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+/** @brief The messages of type T a node defers until its level is high
+ *  enough. Messages are bucketed by level, so raising the level releases
+ *  exactly the eligible ones, and indexed by the uid of their contact point,
+ *  so the request of a given contact point is found in O(log n). Messages
+ *  are released in arrival order. The cache owns the messages it holds.
+ *  @author A.G. Medrano-Chavez
+ */
+template <typename T>
+class PendingCache {
+private:
+  /** @brief The level of a message and its arrival number */
+  typedef std::pair<int, unsigned long> Slot;
+  /** @brief The contact point of a message and its arrival number */
+  typedef std::pair<int, unsigned long> Contact;
+  typedef std::map<Slot, std::pair<T*, int>> Entries;
+  /** @brief The messages, ordered by level, and their contact points */
+  Entries entries;
+  /** @brief The level of each message having a contact point */
+  std::map<Contact, int> index;
+  /** @brief The arrival number of the next message */
+  unsigned long arrivals;
+  /** @brief Removes the messages preceding an entry and hands them to f in
+   *  arrival order */
+  template <typename F>
+  void releaseUntil(typename Entries::iterator end, F f) {
+    std::vector<std::pair<unsigned long, T*>> released;
+    for (auto it = entries.begin(); it != end; it = entries.erase(it)) {
+      unsigned long arrival = it->first.second;
+      if (it->second.second >= 0)
+        index.erase(Contact(it->second.second, arrival));
+      released.emplace_back(arrival, it->second.first);
+    }
+    std::sort(released.begin(), released.end());
+    for (auto& entry : released)
+      f(entry.second);
+  }
+public:
+  PendingCache() : arrivals(0) { }
+  PendingCache(const PendingCache&) = delete;
+  PendingCache& operator=(const PendingCache&) = delete;
+  ~PendingCache() {
+    for (auto& entry : entries)
+      delete entry.second.first;
+  }
+  bool empty() const { return entries.empty(); }
+  int size() const { return entries.size(); }
+  /** @brief Defers a message
+   *  @param msg The message
+   *  @param level The level of the message
+   *  @param contactPoint The uid of its contact point, -1 if it has none
+   */
+  void push(T* msg, int level, int contactPoint = -1) {
+    unsigned long arrival = arrivals++;
+    entries[Slot(level, arrival)] = std::make_pair(msg, contactPoint);
+    if (contactPoint >= 0)
+      index[Contact(contactPoint, arrival)] = level;
+  }
+  /** @brief Removes the first message of a contact point
+   *  @return The message, nullptr if there is none
+   */
+  T* take(int contactPoint) {
+    auto it = index.lower_bound(Contact(contactPoint, 0));
+    if (it == index.end() || it->first.first != contactPoint)
+      return nullptr;
+    auto entry = entries.find(Slot(it->second, it->first.second));
+    T* msg = entry->second.first;
+    entries.erase(entry);
+    index.erase(it);
+    return msg;
+  }
+  /** @brief Removes the messages whose level is lower than a given one and
+   *  hands them to f in arrival order */
+  template <typename F>
+  void releaseBelow(int level, F f) {
+    releaseUntil(entries.lower_bound(Slot(level, 0)), f);
+  }
+  /** @brief Removes the messages whose level is not greater than a given
+   *  one and hands them to f in arrival order */
+  template <typename F>
+  void releaseUpTo(int level, F f) {
+    releaseUntil(entries.upper_bound(Slot(level, ~0ul)), f);
+  }
+};
+
+#endif // PENDING_CACHE_H
@@ -0,0 +1,316 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#if !defined(PRIORITY_QUEUE_H)
+#define PRIORITY_QUEUE_H
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/** @brief The priority queues in this file hold the vertices 0..n-1 of a
+ *  graph and share the interface the shortest-path engine relies on:
+ *  - update(v, key) inserts v or lowers its key,
+ *  - pop() removes and returns the vertex with the minimum key,
+ *  - empty() tells whether some vertex is still queued.
+ *  @author A.G. Medrano-Chavez
+ */
+
+/** @brief Binary min-heap with decrease-key. The position of every vertex
+ *  is tracked, so update() costs O(log n) and no stale entries are kept.
+ */
+template <typename K>
+class BinaryHeap {
+public:
+  typedef K Key;
+private:
+  /** @brief The heap itself, it stores vertices */
+  std::vector<int> heap;
+  /** @brief The index of each vertex in the heap, -1 if it is not queued */
+  std::vector<int> position;
+  /** @brief The key of each vertex */
+  std::vector<Key> keys;
+  void place(int i, int v) {
+    heap[i] = v;
+    position[v] = i;
+  }
+  void siftUp(int i) {
+    int v = heap[i];
+    while (i > 0) {
+      int parent = (i - 1) / 2;
+      if (!(keys[v] < keys[heap[parent]]))
+        break;
+      place(i, heap[parent]);
+      i = parent;
+    }
+    place(i, v);
+  }
+  void siftDown(int i) {
+    int v = heap[i];
+    int n = heap.size();
+    while (true) {
+      int child = 2 * i + 1;
+      if (child >= n)
+        break;
+      if (child + 1 < n && keys[heap[child + 1]] < keys[heap[child]])
+        child++;
+      if (!(keys[heap[child]] < keys[v]))
+        break;
+      place(i, heap[child]);
+      i = child;
+    }
+    place(i, v);
+  }
+public:
+  /** @brief Builds an empty heap for the vertices 0..capacity-1 */
+  explicit BinaryHeap(int capacity) : position(capacity, -1), keys(capacity) {
+    heap.reserve(capacity);
+  }
+  bool empty() const { return heap.empty(); }
+  bool contains(int v) const { return position[v] >= 0; }
+  /** @brief Returns the vertex with the minimum key without removing it */
+  int top() const { return heap.front(); }
+  /** @brief Returns the key associated to a queued vertex */
+  const Key& key(int v) const { return keys[v]; }
+  /** @brief Inserts a vertex that is not queued */
+  void push(int v, const Key& key) {
+    keys[v] = key;
+    heap.push_back(v);
+    siftUp(heap.size() - 1);
+  }
+  /** @brief Lowers the key of a queued vertex */
+  void decreaseKey(int v, const Key& key) {
+    keys[v] = key;
+    siftUp(position[v]);
+  }
+  void update(int v, const Key& key) {
+    if (contains(v))
+      decreaseKey(v, key);
+    else
+      push(v, key);
+  }
+  /** @brief Sets the key of a queued vertex, it may be raised or lowered */
+  void changeKey(int v, const Key& key) {
+    keys[v] = key;
+    siftUp(position[v]);
+    siftDown(position[v]);
+  }
+  /** @brief Removes a queued vertex */
+  void erase(int v) {
+    int i = position[v];
+    int last = heap.back();
+    position[v] = -1;
+    heap.pop_back();
+    if (last != v) {
+      place(i, last);
+      siftUp(i);
+      siftDown(position[last]);
+    }
+  }
+  int pop() {
+    int v = heap.front();
+    position[v] = -1;
+    if (heap.size() > 1) {
+      heap.front() = heap.back();
+      heap.pop_back();
+      siftDown(0);
+    }
+    else
+      heap.pop_back();
+    return v;
+  }
+};
+
+/** @brief Pairing heap with decrease-key. Nodes are preallocated per vertex,
+ *  thus no allocation takes place while the heap is in use. Insertion and
+ *  decrease-key are O(1), pop() is O(log n) amortized.
+ */
+template <typename K>
+class PairingHeap {
+public:
+  typedef K Key;
+private:
+  struct Node {
+    Key key;
+    int child;    // The leftmost child
+    int sibling;  // The right sibling
+    int prev;     // The parent of a leftmost child, the left sibling otherwise
+    bool queued;
+  };
+  std::vector<Node> nodes;
+  /** @brief Scratch space of the two-pass merge */
+  std::vector<int> pairs;
+  int root;
+  /** @brief Links two roots, the one with the greater key becomes the
+   *  leftmost child of the other */
+  int meld(int a, int b) {
+    if (nodes[b].key < nodes[a].key)
+      std::swap(a, b);
+    nodes[b].prev = a;
+    int child = nodes[a].child;
+    nodes[b].sibling = child;
+    if (child >= 0)
+      nodes[child].prev = b;
+    nodes[a].child = b;
+    return a;
+  }
+  /** @brief Melds a list of siblings by the standard two-pass strategy */
+  int mergePairs(int first) {
+    if (first < 0)
+      return -1;
+    pairs.clear();
+    while (first >= 0) {
+      int a = first;
+      int b = nodes[a].sibling;
+      nodes[a].sibling = nodes[a].prev = -1;
+      if (b < 0) {
+        pairs.push_back(a);
+        break;
+      }
+      first = nodes[b].sibling;
+      nodes[b].sibling = nodes[b].prev = -1;
+      pairs.push_back(meld(a, b));
+    }
+    int r = pairs.back();
+    for (int i = int(pairs.size()) - 2; i >= 0; i--)
+      r = meld(pairs[i], r);
+    return r;
+  }
+public:
+  /** @brief Builds an empty heap for the vertices 0..capacity-1 */
+  explicit PairingHeap(int capacity)
+    : nodes(capacity, Node{Key(), -1, -1, -1, false})
+    , root(-1)
+  { }
+  bool empty() const { return root < 0; }
+  bool contains(int v) const { return nodes[v].queued; }
+  int top() const { return root; }
+  void push(int v, const Key& key) {
+    nodes[v] = Node{key, -1, -1, -1, true};
+    root = (root < 0) ? v : meld(root, v);
+  }
+  void decreaseKey(int v, const Key& key) {
+    Node& node = nodes[v];
+    node.key = key;
+    if (v == root)
+      return;
+    // Cuts the subtree rooted at v, then melds it with the root
+    if (nodes[node.prev].child == v)
+      nodes[node.prev].child = node.sibling;
+    else
+      nodes[node.prev].sibling = node.sibling;
+    if (node.sibling >= 0)
+      nodes[node.sibling].prev = node.prev;
+    node.sibling = node.prev = -1;
+    root = (root < 0) ? v : meld(root, v);
+  }
+  void update(int v, const Key& key) {
+    if (contains(v))
+      decreaseKey(v, key);
+    else
+      push(v, key);
+  }
+  int pop() {
+    int v = root;
+    nodes[v].queued = false;
+    root = mergePairs(nodes[v].child);
+    nodes[v].child = -1;
+    return v;
+  }
+};
+
+/** @brief Radix heap for non-negative integer keys. It is a monotone queue:
+ *  the keys passed to update() must not be lower than the last popped key,
+ *  which always holds in Dijkstra's algorithm. Decrease-key inserts a new
+ *  entry, the outdated ones are skipped by pop(). Each entry moves to a
+ *  lower bucket at most 64 times, so pop() is O(log C) amortized, where C is
+ *  the maximum key.
+ */
+class RadixHeap {
+public:
+  typedef std::uint64_t Key;
+private:
+  enum State : char { ABSENT = 0, QUEUED, POPPED };
+  /** @brief Bucket i holds the keys whose highest bit differing from the
+   *  last popped key is the bit i-1. Bucket 0 holds keys equal to it */
+  std::array<std::vector<std::pair<Key, int>>, 65> buckets;
+  std::vector<Key> keys;
+  std::vector<State> state;
+  /** @brief The last popped key */
+  Key last;
+  /** @brief The number of queued vertices */
+  int size;
+  static int bucketOf(Key key, Key last) {
+    Key x = key ^ last;
+#if defined(__GNUC__)
+    return x ? 64 - __builtin_clzll(x) : 0;
+#else
+    int b = 0;
+    for (; x; x >>= 1)
+      b++;
+    return b;
+#endif
+  }
+  /** @brief Moves the minimum of the first non-empty bucket to bucket 0 and
+   *  redistributes the remaining entries of that bucket */
+  void refill() {
+    int i = 1;
+    while (buckets[i].empty())
+      i++;
+    Key min = buckets[i].front().first;
+    for (auto& entry : buckets[i])
+      if (entry.first < min)
+        min = entry.first;
+    last = min;
+    for (auto& entry : buckets[i])
+      buckets[bucketOf(entry.first, last)].push_back(entry);
+    buckets[i].clear();
+  }
+public:
+  /** @brief Builds an empty heap for the vertices 0..capacity-1 */
+  explicit RadixHeap(int capacity)
+    : keys(capacity)
+    , state(capacity, State::ABSENT)
+    , last(0)
+    , size(0)
+  { }
+  bool empty() const { return size == 0; }
+  bool contains(int v) const { return state[v] == State::QUEUED; }
+  void update(int v, Key key) {
+    if (state[v] != State::QUEUED) {
+      state[v] = State::QUEUED;
+      size++;
+    }
+    keys[v] = key;
+    buckets[bucketOf(key, last)].emplace_back(key, v);
+  }
+  int pop() {
+    while (true) {
+      if (buckets[0].empty())
+        refill();
+      auto entry = buckets[0].back();
+      buckets[0].pop_back();
+      int v = entry.second;
+      if (state[v] == State::QUEUED && keys[v] == entry.first) {
+        state[v] = State::POPPED;
+        size--;
+        return v;
+      }
+    }
+  }
+};
+
+#endif // PRIORITY_QUEUE_H
@@ -0,0 +1,128 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+// 
+
+#if !defined(PROTOCOL_SPEC_H)
+#define PROTOCOL_SPEC_H
+
+#include <type_traits>
+#include <utility>
+
+#include "BaseAction.h"
+#include "RuleTable.h"
+
+/** @brief The class of the messages carrying events of kind E. Protocols
+ *  specialize it for their own messages, e.g.,
+ *
+ *  template <> struct MessageOf<EventKind::HELLO> { typedef HelloMsg type; };
+ */
+template <EventKind E>
+struct MessageOf {
+  typedef omnetpp::cMessage type;
+};
+
+/** @brief Tells whether an action accepts a pointer to a message */
+template <typename A, typename M, typename = void>
+struct Accepts : std::false_type { };
+
+template <typename A, typename M>
+struct Accepts<
+  A, M, decltype(void(std::declval<A&>()(std::declval<M*>())))
+> : std::true_type { };
+
+/** @brief The enabler (status, event) of a rule as a type, so that rules can
+ *  be compared at compile time */
+template <Status::Code, EventKind>
+struct RuleKey { };
+
+/** @brief A rule (status, event) -> action of a protocol specification. When
+ *  the rule fires, the action receives the message as a MessageOf<E> by a
+ *  static cast: the table dispatches by event kind, so the kind already
+ *  tells the class of the message.
+ */
+template <Status::Code S, EventKind E, typename A>
+struct Rule {
+  typedef typename MessageOf<E>::type Message;
+  typedef typename A::NodeType Node;
+  typedef RuleKey<S, E> Key;
+  static_assert(
+    Accepts<A, Message>::value,
+    "the action does not accept the message class of its event kind"
+  );
+  static void run(BaseNode* node, omnetpp::cMessage* msg) {
+    A(static_cast<Node*>(node))(static_cast<Message*>(msg));
+  }
+  static void addTo(RuleTable& table) {
+    table.addRule(
+      S, E, ActionEntry{&run, omnetpp::opp_typename(typeid(A))}
+    );
+  }
+};
+
+/** @brief Tells whether T is one of Ts */
+template <typename T, typename... Ts>
+struct IsOneOf : std::false_type { };
+
+template <typename T, typename U, typename... Ts>
+struct IsOneOf<T, U, Ts...>
+  : std::integral_constant<
+      bool, std::is_same<T, U>::value || IsOneOf<T, Ts...>::value
+    > { };
+
+/** @brief Tells whether every type of a list is different */
+template <typename... Ts>
+struct AreDistinct : std::true_type { };
+
+template <typename T, typename... Ts>
+struct AreDistinct<T, Ts...>
+  : std::integral_constant<
+      bool, !IsOneOf<T, Ts...>::value && AreDistinct<Ts...>::value
+    > { };
+
+/** @brief The rule set of a protocol, declared as a list of rules:
+ *
+ *  typedef ProtocolSpec<
+ *    Rule<Status::IDLE, EventKind::IMPULSE, WakingUp>,
+ *    ...
+ *  > Protocol;
+ *
+ *  The list is checked at compile time: two rules with the same enabler, or
+ *  an action that does not accept the message class of its event kind, do
+ *  not compile. The rule table of the protocol is generated from the list.
+ */
+template <typename... Rules>
+struct ProtocolSpec {
+  static_assert(
+    AreDistinct<typename Rules::Key...>::value,
+    "two rules of the protocol have the same enabler"
+  );
+  /** @brief Adds the rules of the specification to a table */
+  static void addRules(RuleTable& table) {
+    int expand[] = {0, (Rules::addTo(table), 0)...};
+    (void)expand;
+  }
+};
+
+/** @brief A specification extending the rules of Base. The rules of the list
+ *  must be different from each other, but they may override rules of Base.
+ */
+template <typename Base, typename... Rules>
+struct ExtendedSpec {
+  static void addRules(RuleTable& table) {
+    Base::addRules(table);
+    ProtocolSpec<Rules...>::addRules(table);
+  }
+};
+
+#endif // PROTOCOL_SPEC_H
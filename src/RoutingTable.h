@@ -0,0 +1,100 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#if !defined(ROUTING_TABLE_H)
+#define ROUTING_TABLE_H
+
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+/** @brief A read-only view of the routing table of one source. Entry i holds
+ *  the predecessor of node i, the port of the source leading to node i and
+ *  the distance between both nodes.
+ */
+struct RoutingRow {
+  const int* prev;
+  const int* port;
+  const double* distance;
+  int size;
+};
+
+/** @brief The routing table of a node. Destinations are the dense node IDs
+ *  0..n-1, so the table is a structure of three arrays indexed by
+ *  destination instead of a map. A table either owns its arrays or views a
+ *  row computed elsewhere, e.g., a row of a shared forest.
+ *  @author A.G. Medrano-Chavez
+ */
+class RoutingTable {
+public:
+  /** @brief An entry of the table: prev. uid, port, distance */
+  typedef std::tuple<int, int, double> Entry;
+private:
+  std::vector<int> prevs;
+  std::vector<int> ports;
+  std::vector<double> distances;
+  /** @brief The arrays read by the accessors */
+  RoutingRow view;
+public:
+  RoutingTable() : view{nullptr, nullptr, nullptr, 0} { }
+  /** @brief Copies would view the arrays of the original table */
+  RoutingTable(const RoutingTable&) = delete;
+  RoutingTable& operator=(const RoutingTable&) = delete;
+  /** @brief Makes the table own n entries, their values are unspecified */
+  void resize(int n) {
+    prevs.resize(n);
+    ports.resize(n);
+    distances.resize(n);
+    view = RoutingRow{prevs.data(), ports.data(), distances.data(), n};
+  }
+  /** @brief Makes the table view a row owned by someone else, the row must
+   *  outlive the table or the next call to resize() or assign() */
+  void assign(const RoutingRow& row) {
+    std::vector<int>().swap(prevs);
+    std::vector<int>().swap(ports);
+    std::vector<double>().swap(distances);
+    view = row;
+  }
+  /** @brief Empties the table */
+  void clear() { assign(RoutingRow{nullptr, nullptr, nullptr, 0}); }
+  /** @brief Returns the number of destinations */
+  int size() const { return view.size; }
+  bool empty() const { return view.size == 0; }
+  /** @brief Returns the predecessor of a destination (-1 if none) */
+  int prev(int destination) const { return view.prev[destination]; }
+  /** @brief Returns the port leading to a destination (-1 if none) */
+  int port(int destination) const { return view.port[destination]; }
+  /** @brief Returns the distance to a destination */
+  double distance(int destination) const {
+    return view.distance[destination];
+  }
+  /** @brief Returns the entry of a destination */
+  Entry operator[](int destination) const {
+    return Entry(prev(destination), port(destination), distance(destination));
+  }
+  /** @brief Returns the entry of a destination, throwing std::out_of_range
+   *  if it is not in the table */
+  Entry at(int destination) const {
+    if (destination < 0 || destination >= view.size)
+      throw std::out_of_range("RoutingTable::at");
+    return (*this)[destination];
+  }
+  /** @brief The arrays of an owned table, for the shortest-path engine */
+  int* prevData() { return prevs.data(); }
+  int* portData() { return ports.data(); }
+  double* distanceData() { return distances.data(); }
+};
+
+#endif // ROUTING_TABLE_H
@@ -0,0 +1,54 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+// 
+
+#if !defined(RULE_TABLE_H)
+#define RULE_TABLE_H
+
+#include <array>
+
+#include "BaseAction.h"
+#include "Event.h"
+#include "Status.h"
+
+/** @brief The rules (status, event) -> action of a node class. Every node of
+ *  a class obeys the same rules, so each class builds its table once, from
+ *  its ProtocolSpec, and all its instances share it. Rules are stored in a
+ *  dense table indexed by [status.index()][event], an empty entry means nil.
+ *  @author A.G. Medrano-Chavez
+ */
+class RuleTable {
+private:
+  std::array<std::array<ActionEntry, EventKind::EVENT_KINDS>, Status::COUNT>
+    rules;
+public:
+  /** @brief Builds an empty table */
+  RuleTable() : rules() { }
+  /** @brief Builds a table by a function adding rules to it */
+  explicit RuleTable(void (*build)(RuleTable&)) : rules() { build(*this); }
+  /** @brief Adds a rule, a previous rule with the same enabler is replaced.
+   *  Protocols add their rules through a ProtocolSpec.
+   */
+  void addRule(const Status& s, EventKind e, const ActionEntry& action) {
+    rules[s.index()][e] = action;
+  }
+  /** @brief Returns the action enabled by a pair (status, event kind). Its
+   *  handler is null if there is no such rule */
+  const ActionEntry& find(const Status& s, int e) const {
+    static const ActionEntry nil = {nullptr, nullptr};
+    return (e >= 0 && e < EventKind::EVENT_KINDS) ? rules[s.index()][e] : nil;
+  }
+};
+
+#endif // RULE_TABLE_H
@@ -0,0 +1,108 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#if !defined(SHORTEST_PATHS_H)
+#define SHORTEST_PATHS_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "CsrGraph.h"
+#include "PriorityQueue.h"
+
+/** @brief The priority queues the shortest-path engine can use */
+enum QueueKind {
+  BINARY_HEAP = 0, // Binary heap with decrease-key
+  PAIRING_HEAP,    // Pairing heap with decrease-key
+  RADIX_HEAP       // Radix heap, it requires integer weights
+};
+
+/** @brief Computes the shortest-path tree rooted at source by Dijkstra's
+ *  algorithm in O(m log n) with any priority queue from PriorityQueue.h.
+ *  The arcs of each vertex are assumed to be in port order, i.e., the i-th
+ *  arc leaving source is reached through port i. Every output array must
+ *  hold graph.size() elements.
+ *  @param graph The weighted graph
+ *  @param source The root of the tree
+ *  @param prev The predecessor of each vertex in the tree (-1 if none)
+ *  @param port The port of source leading to each vertex (-1 if none)
+ *  @param distance The distance from source to each vertex
+ */
+template <typename Queue>
+void shortestPaths(
+  const CsrGraph& graph,
+  int source,
+  int* prev,
+  int* port,
+  double* distance
+) {
+  typedef typename Queue::Key Key;
+  int n = graph.size();
+  std::fill(prev, prev + n, -1);
+  std::fill(port, port + n, -1);
+  std::fill(distance, distance + n, std::numeric_limits<double>::infinity());
+  Queue queue(n);
+  distance[source] = 0.0;
+  queue.update(source, Key(0));
+  while (!queue.empty()) {
+    int u = queue.pop();
+    for (int e = graph.begin(u); e < graph.end(u); e++) {
+      int v = graph.target(e);
+      double d = distance[u] + graph.weight(e);
+      if (d < distance[v]) {
+        distance[v] = d;
+        prev[v] = u;
+        port[v] = (u == source) ? e - graph.begin(u) : port[u];
+        queue.update(v, static_cast<Key>(d));
+      }
+    }
+  }
+}
+
+/** @brief Computes the shortest-path tree rooted at source with the priority
+ *  queue selected at runtime. See the template version for the details */
+inline void shortestPaths(
+  QueueKind queue,
+  const CsrGraph& graph,
+  int source,
+  int* prev,
+  int* port,
+  double* distance
+) {
+  switch (queue) {
+  case QueueKind::BINARY_HEAP:
+    shortestPaths<BinaryHeap<double>>(graph, source, prev, port, distance);
+    break;
+  case QueueKind::PAIRING_HEAP:
+    shortestPaths<PairingHeap<double>>(graph, source, prev, port, distance);
+    break;
+  case QueueKind::RADIX_HEAP:
+    shortestPaths<RadixHeap>(graph, source, prev, port, distance);
+    break;
+  }
+}
+
+/** @brief Tells whether every weight of a graph is a non-negative integer,
+ *  which is the requirement of the radix heap */
+inline bool hasIntegerWeights(const CsrGraph& graph) {
+  for (double weight : graph.getWeights())
+    if (weight < 0 || weight != std::floor(weight))
+      return false;
+  return true;
+}
+
+#endif // SHORTEST_PATHS_H
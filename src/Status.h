@@ -17,92 +17,86 @@
 #define STATUS_H
 
 #include <iostream>
+#include <type_traits>
 
 /** @brief This class could be modified if the current set of possible status
  *  is not enough to implement a distributed algorithm. Take care about 
- *  processing the status into the str() member function
+ *  processing the status into the str() member function. A status is a
+ *  literal type holding a single byte: comparisons inline and the status
+ *  works as an index of dispatch tables, see index().
  *  @author A.G. Medrano-Chavez
 */
 class Status {
+public:
+  /** @brief The possible status of a node */
+  enum Code : signed char {
+    /** @brief Status of nodes that have not been initialized */
+    UNSPECIFIED = -1,
+    /** @brief Status associated to the node that starting a protocol */
+    INITIATOR,
+    /** @brief Status associated to nodes that have not received any message */
+    IDLE,
+    /** @brief Status associated to nodes waiting for a message */
+    ACTIVE,
+    /** @brief Status associated to nodes unactive nodes */
+    SLEEP,
+    /** @brief Status associated to nodes that do not have any actions to do */
+    DONE,
+    /** @brief Status associated to the coordinator of a network */
+    LEADER,
+    /** @brief Status associated to nodes that performs tasks stated by a leader*/
+    FOLLOWER,
+    /** @brief Status associated to possible leaders */
+    SATURATED,
+    /** @brief Status associated to nodes processing data */
+    PROCESSING,
+    /** @brief Status associated to nodes updating their data structures */
+    UPDATING,
+    /** @brief Status associated to nodes trying to establish a connection */
+    CONNECTING,
+    /** @brief Status of routers */
+    ROUTING
+  };
+  /** @brief The number of status, UNSPECIFIED included */
+  static constexpr int COUNT = ROUTING + 2;
 private:
   /** @brief A variable holding the node status */
-  int status;
-  /** @brief Overloaded constructor taking values from the static variables 
-   *  from this class */
-  Status(int s) : status(s) { }
+  Code status;
 public:
-  /** @brief Status associated to the node that starting a protocol */
-  static const Status UNSPECIFIED;
-  /** @brief Status associated to the node that starting a protocol */
-  static const Status INITIATOR;
-  /** @brief Status associated to nodes that have not received any message */
-  static const Status IDLE;
-  /** @brief Status associated to nodes waiting for a message */
-  static const Status ACTIVE;
-  /** @brief Status associated to nodes unactive nodes */
-  static const Status SLEEP;
-  /** @brief Status associated to nodes processing data */
-  static const Status PROCESSING;
-  /** @brief Status associated to possible leaders */
-  static const Status SATURATED;
-  /** @brief Status associated to the coordinator of a network */
-  static const Status LEADER;
-  /** @brief Status associated to nodes that performs tasks stated by a leader*/
-  static const Status FOLLOWER;
-  /** @brief Status associated to nodes that do not have any actions to do */
-  static const Status DONE;
-  /** @brief Status associated to nodes updating their data structures */
-  static const Status UPDATING;
-  /** @brief Status associated to nodes trying to establish a connection */
-  static const Status CONNECTING;
-  /** @brief Status of routers */
-  static const Status ROUTING;
   /** @brief Default constructor */
-  Status() : status(-1) { }
-  /** @brief Overloaded constructor taking values from the static variables 
-   *  from this class */
-  Status(const Status& s) : status(s.status) { }
-  /** @brief Assings a possible status of this set*/
-  virtual Status& operator=(const Status& s) {
-    status = s.status; 
-    return *this; 
-  }
-  /** @brief Returns the numeric value associated to the status */
-  virtual int get() {return status;}
+  constexpr Status() : status(UNSPECIFIED) { }
+  /** @brief Builds a status from a code, e.g., Status s = Status::IDLE */
+  constexpr Status(Code s) : status(s) { }
+  /** @brief Returns the code of the status */
+  constexpr Code code() const { return status; }
   /** @brief Returns the numeric value associated to the status */
-  virtual int get() const {return status;}
-  /** @brief Comparation of status of this set*/
-  virtual bool operator==(const Status& s) {
-    return status == s.status; 
-  }
+  constexpr int get() const { return status; }
+  /** @brief Returns the status as an index in 0..COUNT-1 */
+  constexpr int index() const { return status + 1; }
   /** @brief Comparation of status of this set*/
-  virtual bool operator==(const Status& s) const {
+  constexpr bool operator==(const Status& s) const {
     return status == s.status; 
   }
   /** @brief Comparation of status of this set*/
-  virtual bool operator!=(const Status& s) {
-    return status != s.status; 
-  }
-  /** @brief Comparation of status of this set*/
-  virtual bool operator!=(const Status& s) const {
+  constexpr bool operator!=(const Status& s) const {
     return status != s.status; 
   }
   /** @brief Returns a c-style string containing the name of the status */
-  virtual const char* str() const {
+  constexpr const char* str() const {
     switch (status) {
-    case 0:  return "INITIATOR";
-    case 1:  return "IDLE";     
-    case 2:  return "ACTIVE";   
-    case 3:  return "SLEEP";    
-    case 4:  return "DONE";     
-    case 5:  return "LEADER";     
-    case 6:  return "FOLLOWER";     
-    case 7:  return "SATURATED";     
-    case 8:  return "PROCESSING";     
-    case 9:  return "UPDATING";    
-    case 10: return "CONNECTING"; 
-    case 11: return "ROUTING"; 
-    default: return "UNDEFINED";
+    case INITIATOR:  return "INITIATOR";
+    case IDLE:       return "IDLE";
+    case ACTIVE:     return "ACTIVE";
+    case SLEEP:      return "SLEEP";
+    case DONE:       return "DONE";
+    case LEADER:     return "LEADER";
+    case FOLLOWER:   return "FOLLOWER";
+    case SATURATED:  return "SATURATED";
+    case PROCESSING: return "PROCESSING";
+    case UPDATING:   return "UPDATING";
+    case CONNECTING: return "CONNECTING";
+    case ROUTING:    return "ROUTING";
+    default:         return "UNDEFINED";
     }
   }
   friend std::ostream& operator<<(std::ostream& os, const Status& s) {
@@ -110,4 +104,9 @@ public:
   }
 };
 
+static_assert(
+  std::is_trivially_copyable<Status>::value && sizeof(Status) == 1,
+  "Status must stay a one-byte literal type"
+);
+
 #endif // STATUS_H
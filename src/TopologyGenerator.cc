@@ -0,0 +1,188 @@
+#include "TopologyGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include <omnetpp.h>
+
+void TopologyGenerator::grid(int size, int columns, bool torus) {
+  n = size;
+  edges.clear();
+  for (int v = 0; v < n; v++) {
+    int column = v % columns;
+    if (column + 1 < columns && v + 1 < n)
+      edges.emplace_back(v, v + 1);
+    else if (torus && column + 1 == columns)
+      edges.emplace_back(v, v - column);
+    if (v + columns < n)
+      edges.emplace_back(v, v + columns);
+    else if (torus)
+      edges.emplace_back(v, v + columns - n);
+  }
+}
+
+void TopologyGenerator::tree(int size, int arity) {
+  n = size;
+  edges.clear();
+  for (int v = 1; v < n; v++)
+    edges.emplace_back((v - 1) / arity, v);
+}
+
+void TopologyGenerator::geometric(int size, double degree) {
+  if (!(degree > 0))
+    throw omnetpp::cRuntimeError(
+      "TopologyGenerator: the degree of a geometric graph must be positive, "
+      "not %g", degree
+    );
+  n = size;
+  edges.clear();
+  const double pi = std::acos(-1.0);
+  double radius = std::sqrt(degree / (pi * std::max(n - 1, 1)));
+  // More cells than points would only add empty ones to the scan
+  int limit = int(std::ceil(std::sqrt(double(std::max(n, 1)))));
+  int cells = std::max(1, int(std::min(1.0 / radius, double(limit))));
+  std::vector<double> px(n), py(n);
+  std::vector<int> pcell(n), first(cells * cells + 1, 0);
+  for (int v = 0; v < n; v++) {
+    px[v] = draw();
+    py[v] = draw();
+    pcell[v] = int(py[v] * cells) * cells + int(px[v] * cells);
+    first[pcell[v] + 1]++;
+  }
+  // Counting sort of the points by cell. Nodes are numbered in sorted
+  // order, so a range of IDs is a strip of the square, which makes ID
+  // ranges good partitions for parallel simulation
+  std::partial_sum(first.begin(), first.end(), first.begin());
+  std::vector<int> next(first.begin(), first.end() - 1);
+  std::vector<double> x(n), y(n);
+  std::vector<int> cell(n);
+  for (int v = 0; v < n; v++) {
+    int k = next[pcell[v]]++;
+    x[k] = px[v];
+    y[k] = py[v];
+    cell[k] = pcell[v];
+  }
+  double r2 = radius * radius;
+  for (int u = 0; u < n; u++) {
+    int row = cell[u] / cells;
+    int column = cell[u] % cells;
+    int top = std::min(row + 1, cells - 1);
+    int right = std::min(column + 1, cells - 1);
+    for (int i = std::max(row - 1, 0); i <= top; i++)
+      for (int j = std::max(column - 1, 0); j <= right; j++)
+        for (int v = first[i * cells + j]; v < first[i * cells + j + 1]; v++) {
+          double dx = x[u] - x[v];
+          double dy = y[u] - y[v];
+          if (u < v && dx * dx + dy * dy < r2)
+            edges.emplace_back(u, v);
+        }
+  }
+}
+
+void TopologyGenerator::erdosRenyi(int size, double degree) {
+  n = size;
+  edges.clear();
+  double p = n > 1 ? degree / (n - 1) : 0.0;
+  if (p <= 0.0)
+    return;
+  if (p >= 1.0) {
+    for (int u = 0; u < n; u++)
+      for (int v = u + 1; v < n; v++)
+        edges.emplace_back(u, v);
+    return;
+  }
+  double logq = std::log(1.0 - p);
+  long v = 1;
+  long w = -1;
+  while (v < n) {
+    w += 1 + long(std::log(1.0 - draw()) / logq);
+    while (w >= v && v < n) {
+      w -= v;
+      v++;
+    }
+    if (v < n)
+      edges.emplace_back(w, v);
+  }
+}
+
+void TopologyGenerator::barabasiAlbert(int size, int m) {
+  n = size;
+  edges.clear();
+  int clique = std::min(m + 1, n);
+  for (int u = 0; u < clique; u++)
+    for (int v = u + 1; v < clique; v++)
+      edges.emplace_back(u, v);
+  // Every link contributes both endpoints, so a uniform draw from this list
+  // picks a node with probability proportional to its degree
+  std::vector<int> endpoints;
+  std::size_t links = edges.size() + std::size_t(n - clique) * m;
+  endpoints.reserve(2 * links);
+  for (auto& edge : edges) {
+    endpoints.push_back(edge.first);
+    endpoints.push_back(edge.second);
+  }
+  std::vector<int> targets;
+  for (int v = clique; v < n; v++) {
+    targets.clear();
+    while (int(targets.size()) < m) {
+      std::uniform_int_distribution<std::size_t> pick(0, endpoints.size() - 1);
+      int u = endpoints[pick(rng)];
+      if (std::find(targets.begin(), targets.end(), u) == targets.end())
+        targets.push_back(u);
+    }
+    for (int u : targets) {
+      edges.emplace_back(u, v);
+      endpoints.push_back(u);
+      endpoints.push_back(v);
+    }
+  }
+}
+
+void TopologyGenerator::connect() {
+  std::vector<int> root(n);
+  std::iota(root.begin(), root.end(), 0);
+  auto find = [&](int v) {
+    while (root[v] != v)
+      v = root[v] = root[root[v]];
+    return v;
+  };
+  for (auto& edge : edges) {
+    int a = find(edge.first);
+    int b = find(edge.second);
+    if (a != b)
+      root[std::max(a, b)] = std::min(a, b);
+  }
+  // The root of a component is its first node
+  for (int v = 1; v < n; v++)
+    if (find(v) == v) {
+      edges.emplace_back(0, v);
+      root[v] = 0;
+    }
+}
+
+void TopologyGenerator::weigh(WeightKind kind, double min, double max) {
+  weights.resize(edges.size());
+  for (auto& weight : weights)
+    switch (kind) {
+      case WeightKind::UNIFORM:
+        weight = min + (max - min) * draw();
+        break;
+      case WeightKind::INTEGER:
+        weight = std::floor(
+          std::ceil(min) + (std::floor(max) - std::ceil(min) + 1) * draw()
+        );
+        break;
+      default:
+        weight = 1.0;
+    }
+}
+
+std::vector<int> TopologyGenerator::degrees() const {
+  std::vector<int> degree(n, 0);
+  for (auto& edge : edges) {
+    degree[edge.first]++;
+    degree[edge.second]++;
+  }
+  return degree;
+}
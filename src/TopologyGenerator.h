@@ -0,0 +1,89 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#if !defined(TOPOLOGY_GENERATOR_H)
+#define TOPOLOGY_GENERATOR_H
+
+#include <random>
+#include <utility>
+#include <vector>
+
+/** @brief The weight distributions of generated links */
+enum WeightKind {
+  UNIT = 0, // Every link weighs one
+  UNIFORM,  // Real weights uniformly drawn from [min, max)
+  INTEGER   // Integer weights uniformly drawn from [min, max]
+};
+
+/** @brief Generates undirected random and regular topologies in time linear
+ *  in the number of nodes plus links, so networks of 10^5-10^6 nodes are
+ *  built in seconds. Links are kept as an edge list in generation order;
+ *  nodes are numbered 0..n-1.
+ *  @author A.G. Medrano-Chavez
+ */
+class TopologyGenerator {
+private:
+  std::mt19937_64 rng;
+  int n;
+  std::vector<std::pair<int, int>> edges;
+  std::vector<double> weights;
+  /** @brief Returns a real number uniformly drawn from [0, 1) */
+  double draw() { return std::uniform_real_distribution<double>()(rng); }
+public:
+  explicit TopologyGenerator(unsigned long seed) : rng(seed), n(0) { }
+  /** @brief Generates a grid of n nodes in rows of a given number of
+   *  columns, the last row may be incomplete. A torus wraps both rows and
+   *  columns around, so it needs n to be a multiple of columns and at least
+   *  three rows and columns. */
+  void grid(int n, int columns, bool torus);
+  /** @brief Generates a complete tree of n nodes numbered level by level,
+   *  every internal node has a given number of children, the last level may
+   *  be incomplete. */
+  void tree(int n, int arity);
+  /** @brief Generates a random geometric graph: n points are uniformly
+   *  placed on the unit square and every pair closer than the radius giving
+   *  the requested average degree is linked. Points are bucketed in cells
+   *  as wide as the radius, so only adjacent cells are compared, and nodes
+   *  are numbered cell by cell, row by row. */
+  void geometric(int n, double degree);
+  /** @brief Generates an Erdos-Renyi G(n, p) graph with p = degree/(n-1).
+   *  Absent links are skipped by geometric jumps (Batagelj-Brandes), so the
+   *  cost is O(n + m) instead of O(n^2). */
+  void erdosRenyi(int n, double degree);
+  /** @brief Generates a Barabasi-Albert graph: it starts from a clique of
+   *  m+1 nodes and every new node links to m distinct nodes chosen with
+   *  probability proportional to their degree, which is done by drawing
+   *  from the list of link endpoints. */
+  void barabasiAlbert(int n, int m);
+  /** @brief Links the components of the topology, if there are several, by
+   *  joining the first node of each one to node 0 */
+  void connect();
+  /** @brief Assigns a weight to every link
+   *  @param kind The weight distribution
+   *  @param min The minimum weight (UNIFORM and INTEGER)
+   *  @param max The maximum weight (UNIFORM and INTEGER)
+   */
+  void weigh(WeightKind kind, double min, double max);
+  /** @brief Returns the number of nodes */
+  int size() const { return n; }
+  /** @brief Returns the links */
+  const std::vector<std::pair<int, int>>& getEdges() const { return edges; }
+  /** @brief Returns the weight of each link, in the order of getEdges() */
+  const std::vector<double>& getWeights() const { return weights; }
+  /** @brief Returns the degree of each node */
+  std::vector<int> degrees() const;
+};
+
+#endif // TOPOLOGY_GENERATOR_H
@@ -0,0 +1,116 @@
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(int size)
+  : job(nullptr)
+  , generation(0)
+  , busy(0)
+  , stopping(false)
+{
+  if (size <= 0)
+    size = std::max(1u, std::thread::hardware_concurrency());
+  for (int i = 0; i < size; i++)
+    workers.emplace_back(new Worker);
+  for (int i = 1; i < size; i++)
+    threads.emplace_back(&WorkStealingPool::loop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto& thread : threads)
+    thread.join();
+}
+
+bool WorkStealingPool::take(int self, int& task) {
+  int n = workers.size();
+  {
+    Worker& own = *workers[self];
+    std::lock_guard<std::mutex> guard(own.lock);
+    if (!own.tasks.empty()) {
+      task = own.tasks.back();
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+  for (int k = 1; k < n; k++) {
+    Worker& victim = *workers[(self + k) % n];
+    std::lock_guard<std::mutex> guard(victim.lock);
+    if (!victim.tasks.empty()) {
+      task = victim.tasks.front();
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingPool::work(int self) {
+  int task;
+  while (take(self, task)) {
+    try {
+      (*job)(task);
+    }
+    catch (...) {
+      std::lock_guard<std::mutex> guard(lock);
+      if (!failure)
+        failure = std::current_exception();
+      // Drains every deque, so the other workers stop taking tasks
+      for (auto& worker : workers) {
+        std::lock_guard<std::mutex> drain(worker->lock);
+        worker->tasks.clear();
+      }
+    }
+  }
+}
+
+void WorkStealingPool::loop(int self) {
+  unsigned seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      wake.wait(guard, [&] { return stopping || generation != seen; });
+      if (stopping)
+        return;
+      seen = generation;
+    }
+    work(self);
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      busy--;
+    }
+    done.notify_one();
+  }
+}
+
+void WorkStealingPool::parallelFor(
+  int tasks, const std::function<void(int)>& job
+) {
+  int n = workers.size();
+  // Each worker starts with a contiguous chunk of tasks
+  for (int i = 0; i < n; i++) {
+    std::lock_guard<std::mutex> guard(workers[i]->lock);
+    for (int task = tasks * i / n; task < tasks * (i + 1) / n; task++)
+      workers[i]->tasks.push_back(task);
+  }
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    this->job = &job;
+    busy = n - 1;
+    generation++;
+  }
+  wake.notify_all();
+  work(0);
+  std::unique_lock<std::mutex> guard(lock);
+  done.wait(guard, [&] { return busy == 0; });
+  this->job = nullptr;
+  if (failure) {
+    std::exception_ptr thrown = failure;
+    failure = nullptr;
+    std::rethrow_exception(thrown);
+  }
+}
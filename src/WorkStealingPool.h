@@ -0,0 +1,80 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#if !defined(WORK_STEALING_POOL_H)
+#define WORK_STEALING_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** @brief A pool of threads running indexed tasks. Every worker owns a deque
+ *  of task indices: it takes tasks from the back of its own deque and, once
+ *  it is empty, steals from the front of the deques of the other workers.
+ *  Hence, workers that get cheap tasks help the ones that get expensive
+ *  tasks. The thread calling parallelFor() acts as worker 0. If a task
+ *  throws, the tasks not started yet are skipped and parallelFor() rethrows
+ *  the exception on the calling thread.
+ *  @author A.G. Medrano-Chavez
+ */
+class WorkStealingPool {
+private:
+  struct Worker {
+    std::mutex lock;
+    std::deque<int> tasks;
+  };
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::thread> threads;
+  /** @brief Protects job, generation, busy, stopping and failure */
+  std::mutex lock;
+  std::condition_variable wake;
+  std::condition_variable done;
+  /** @brief The job of the current parallelFor() call */
+  const std::function<void(int)>* job;
+  /** @brief The number of parallelFor() calls so far */
+  unsigned generation;
+  /** @brief The number of threads still working on the current job */
+  int busy;
+  bool stopping;
+  /** @brief The first exception thrown by a task of the current job */
+  std::exception_ptr failure;
+  /** @brief Takes a task from the deque of a worker or steals one */
+  bool take(int self, int& task);
+  /** @brief Runs tasks until every deque is empty */
+  void work(int self);
+  /** @brief The main loop of the pool threads */
+  void loop(int self);
+public:
+  /** @brief Starts a pool
+   *  @param size The number of workers, zero means one per core
+   */
+  explicit WorkStealingPool(int size = 0);
+  /** @brief Stops the pool threads */
+  ~WorkStealingPool();
+  /** @brief Returns the number of workers */
+  int size() const { return workers.size(); }
+  /** @brief Runs job(0), ..., job(tasks-1) on the pool and waits for them
+   *  @param tasks The number of tasks
+   *  @param job The function to run for each task index
+   */
+  void parallelFor(int tasks, const std::function<void(int)>& job);
+};
+
+#endif // WORK_STEALING_POOL_H